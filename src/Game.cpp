@@ -1,5 +1,6 @@
 #include <glad/glad.h>
 #include <algorithm>
+#include <cstdlib>
 #include <SDL_ttf.h>
 #include <fstream>
 #include <sstream>
@@ -13,44 +14,63 @@
 #include "actors/OrbitActor.hpp"
 #include "actors/SplineActor.hpp"
 #include "components/render/SpriteComponent.hpp"
-#include "components/render/MeshComponent.hpp"
-#include "components/control/AudioComponent.hpp"
 #include "core/Shader.hpp"
 #include "helper/VertexArray.hpp"
 #include "helper/Texture.hpp"
 #include "core/Renderer.hpp"
+#include "core/NullRenderer.hpp"
 #include "core/InputSystem.hpp"
 #include "core/PhysWorld.hpp"
+#include "core/LevelLoader.hpp"
+#include "core/WorldStreamer.hpp"
 #include "audio/AudioSystem.hpp"
-#include "actors/TargetActor.hpp"
+#include "audio/NullAudioSystem.hpp"
 #include "ui/Font.hpp"
 #include "ui/UIScreen.hpp"
 #include "ui/PauseMenu.hpp"
 #include "ui/HUD.hpp"
+#include "helper/Profiler.hpp"
+#include "helper/Random.hpp"
+#include "helper/PoolAllocator.hpp"
 
 
 Game::Game() = default;
 std::string Game::PROJECT_BASE = "/Users/lunafreya/Programming/CLionProjects/my-minimal-game-engine/src/";
 
-bool Game::Initialize() {
-    // Take in a bitwise-or of all subsystems to initialize
-    int sdlResult = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER);
+bool Game::Initialize(bool headless) {
+    mHeadless = headless;
+
+    // Take in a bitwise-or of all subsystems to initialize, no video device when headless
+    Uint32 sdlFlags = mHeadless ? SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER;
+    int sdlResult = SDL_Init(sdlFlags);
     if (sdlResult) {  // non-zero means error
         SDL_Log("Unable to initialize SDL: %s", SDL_GetError());  // like printf
         return false;
     }
 
+    // Worker threads for every parallel system
+    if (!mJobSystem.Initialize(mWorkerCount)) {
+        SDL_Log("Failed to initialize job system");
+        return false;
+    }
+
     // Create the renderer, move most of the game renderer part to Renderer
-    mRenderer = new Renderer(this);
+    mRenderer = mHeadless ? new NullRenderer(this) : new Renderer(this);
     if (!mRenderer->Initialize(SCREEN_WIDTH, SCREEN_HEIGHT)) {
         SDL_Log("Failed to initialize renderer");
         delete mRenderer;
         mRenderer = nullptr;
         return false;
     }
+    mRenderer->SetDepthPrepass(mDepthPrepass);
+
+    // Content folders to hot reload from
+    if (mHotReload && !mAssetWatcher.Start({"Assets", "shaders"})) {
+        SDL_Log("Hot reload disabled");
+    }
 
     // Initialize FMOD audio
-    mAudioSystem = new AudioSystem(this);
+    mAudioSystem = mHeadless ? new NullAudioSystem(this) : new AudioSystem(this);
     if (!mAudioSystem->Initialize()) {
         SDL_Log("Failed to initialize audio system");
         mAudioSystem->Shutdown();
@@ -69,41 +89,112 @@ bool Game::Initialize() {
     // Create the physics world
     mPhysWorld = new PhysWorld(this);
 
+    // Streaming must not depend on load timing when the session is recorded or replayed
+    mWorldStreamer = new WorldStreamer(this);
+    mWorldStreamer->SetBlocking(!mRecordFile.empty() || !mReplayFile.empty());
+
     // Initialize font, similar to sdl image
     if (TTF_Init() != 0) {
         SDL_Log("Failed to initialize SDL_ttf");
         return false;
     }
 
-    // Initialize all actors AFTER everything
+    // Seed RNG, the seed goes into the input log so a replay spawns the same things
+    unsigned int seed = std::random_device()();
+    if (!mReplayFile.empty()) {
+        if (!mInputRecorder.StartReplay(mReplayFile, seed)) {
+            return false;
+        }
+    } else if (!mRecordFile.empty()) {
+        if (!mInputRecorder.StartRecording(mRecordFile, seed)) {
+            return false;
+        }
+    }
+    Random::Seed(seed);
+
+    // Initialize all actors AFTER everything, world transforms ready for the first frame
     LoadData();
+    mEntities.UpdateWorldTransforms();
 
-    // Initialize ticks
-    mTicksCount = SDL_GetTicks();
+    // Initialize frame timing
+    mFrameLimiter.Reset();
 
     return true;
 }
 
 void Game::Shutdown() {
+    mAssetWatcher.Stop();
+    mInputRecorder.Stop();
+    mFrameLimiter.LogStats();
+    Profiler::WriteChromeTrace(PROFILE_TRACE_FILE);
+
     // Cleanup
     UnloadData();
     TTF_Quit();
+    delete mWorldStreamer;
     delete mPhysWorld;
     if (mInputSystem) mInputSystem->Shutdown();
     if (mAudioSystem) mAudioSystem->Shutdown();
     if (mRenderer) mRenderer->Shutdown();
+    mJobSystem.Shutdown();
     SDL_Quit();
 }
 
 void Game::RunLoop() {
     while (mGameState != EQuit) {
-        ProcessInput();
-        UpdateGame();
-        GenerateOutput();
+        PROFILE_SCOPE("Frame");
+
+        // Sleep until the frame is due instead of busy waiting, get real frame time in second
+        float frameTime;
+        {
+            PROFILE_SCOPE("FrameLimiter::WaitForNextFrame");
+            frameTime = mFrameLimiter.WaitForNextFrame();
+        }
+        if (mFastForward) {
+            // Exactly one step per loop, limiter only measures throughput
+            frameTime = mFixedDeltaTime;
+        }
+
+        // Clamp maximum frame time to prevent huge catch up (ex, when stepping through debugger)
+        mAccumulator += std::min(frameTime, 0.25f);
+
+        // Consume accumulated time in fixed steps, so simulation doesn't depend on frame rate
+        int steps = 0;
+        while (mAccumulator >= mFixedDeltaTime && steps < mMaxSimSteps && mGameState != EQuit) {
+            ProcessInput();
+            if (mGameState == EQuit) break;  // replay ended
+
+            // Replay uses recorded step length so a log made at another rate still matches
+            UpdateGame(mInputRecorder.IsReplaying() ? mInputRecorder.GetFrameDeltaTime() : mFixedDeltaTime);
+            mAccumulator -= mFixedDeltaTime;
+            mSimulatedTime += mFixedDeltaTime;
+            steps++;
+        }
+
+        if (mRunDuration > 0 && mSimulatedTime >= mRunDuration) {
+            mGameState = EQuit;
+        }
+
+        // Can't keep up, drop the remaining time instead of spiraling
+        if (steps == mMaxSimSteps) {
+            mAccumulator = std::min(mAccumulator, mFixedDeltaTime);
+        }
+
+        // Render state between last two steps. Paused steps don't move anything, so the last step
+        // would be blended again every frame, show it as is
+        GenerateOutput(mGameState == EGameplay ? mAccumulator / mFixedDeltaTime : 1.0f);
+    }
+}
+
+void Game::SetFastForward(bool value) {
+    mFastForward = value;
+    if (mFastForward) {
+        mFrameLimiter.SetTargetRate(0);
     }
 }
 
 void Game::ProcessInput() {
+    PROFILE_SCOPE("Game::ProcessInput");
     mInputSystem->PrepareForUpdate();
 
     // POLL SDL event
@@ -119,9 +210,17 @@ void Game::ProcessInput() {
         }
     }
 
-    // POLL actual event
-    mInputSystem->Update();
+    // POLL actual event, or take it from the replay log
+    if (mInputRecorder.IsReplaying()) {
+        if (!mInputRecorder.ReplayFrame(mInputSystem)) {
+            mGameState = EQuit;
+            return;
+        }
+    } else {
+        mInputSystem->Update();
+    }
     const InputState& state = mInputSystem->GetState();
+    mInputRecorder.RecordFrame(state, mFixedDeltaTime);
 
     // Handle keypress in gameplay or ui
     if (mGameState == EGameplay) {
@@ -131,55 +230,75 @@ void Game::ProcessInput() {
         mUIStack.back()->HandleKeyPress(state);
     }
 
-    // Send state to all actor or ui
+    // Send state to actors listening for input or ui
     if (mGameState == EGameplay) {
-        mUpdatingActors = true;
-        for (auto actor: mActors) {
-            actor->ProcessInput(state);
+        for (size_t i = 0, count = mInputActors.size(); i < count; i++) {
+            mInputActors[i]->ProcessInput(state);
         }
-        mUpdatingActors = false;
     }
     else if (!mUIStack.empty()) {
         mUIStack.back()->ProcessInput(state);
     }
 }
 
-void Game::UpdateGame() {
-    // Simple solution for frame limiting.
-    // Wait until 16ms has elapsed since last frame
-    while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16));
-
-    // Get delta in second
-    float deltaTime = static_cast<float>(SDL_GetTicks() - mTicksCount) / 1000.0f;
-    mTicksCount = SDL_GetTicks();
-
-    // Clamp maximum delta to prevent huge delta time (ex, when stepping through debugger)
-    deltaTime = std::min(deltaTime, 0.05f);
-
+void Game::UpdateGame(float deltaTime) {
+    PROFILE_SCOPE("Game::UpdateGame");
     // Only update in gameplay mode
     if (mGameState == EGameplay) {
-        // Update all existing actors
+        // Load/unload level cells around the player before anything updates
+        if (mFPSActor) {
+            mWorldStreamer->Update(mFPSActor->GetPosition());
+        }
+
+        // Data oriented systems first, same as MoveComponent having the lowest update order
+        mEntities.BeginStep();
+        mEntities.UpdateMovement(deltaTime);
+
+        // Update active actors only, index loop because new actors are appended while updating.
+        // State changes are applied after the loop so the active list doesn't shift under us.
+        // Serial actors may touch anything so they go first, parallel ones are gathered
+        const auto &actors = mActors.GetBucket(Actor::EActive);
+        size_t count = actors.size();
+        mParallelActors.clear();
         mUpdatingActors = true;
-        for (auto &actor: mActors)
-            actor->Update(deltaTime);
+        for (size_t i = 0; i < count; i++) {
+            if (actors[i]->IsParallelUpdate()) {
+                mParallelActors.emplace_back(actors[i]);
+            } else {
+                actors[i]->Update(deltaTime);
+            }
+        }
         mUpdatingActors = false;
-
-        // Add pending vector
-        for (auto &pending: mPendingActors) {
-            pending->ComputeWorldTransform();  // have their world transform calculated
-            mActors.emplace_back(pending);
+        for (auto handle: mPendingStateChanges) {
+            if (Actor *actor = mActors.Get(handle)) {
+                mActors.SetBucket(handle, actor->GetState());
+            }
         }
-        mPendingActors.clear();
-
-        // Check dead vector and remove
-        vector<Actor *> deadActors;
-        for (auto &actor: mActors) {
-            if (actor->GetState() == Actor::EDead)
-                deadActors.emplace_back(actor);
+        mPendingStateChanges.clear();
+
+        // Parallel actors on all threads, structural changes are merged at the end
+        {
+            PROFILE_SCOPE("Game::UpdateParallelActors");
+            mEntities.BeginParallelRead();
+            mCommands.Begin(mJobSystem.GetThreadCount());
+            mJobSystem.ParallelFor(static_cast<uint32_t>(mParallelActors.size()), PARALLEL_UPDATE_BATCH,
+                                   [this, deltaTime](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    CommandBuffer::SetOrder(i);
+                    mParallelActors[i]->Update(deltaTime);
+                }
+            });
+            mEntities.EndParallelRead();
+            mCommands.Playback();
         }
 
-        for (auto actor: deadActors) {
-            delete actor;
+        // World transforms of everything that moved (or spawned) this step, parents before children
+        mEntities.UpdateWorldTransforms();
+
+        // Only actors that died this step are in the dead list, ~Actor removes them from it
+        const auto &deadActors = mActors.GetBucket(Actor::EDead);
+        while (!deadActors.empty()) {
+            delete deadActors.back();
         }
     }
 
@@ -205,36 +324,69 @@ void Game::UpdateGame() {
     }
 }
 
-void Game::GenerateOutput() {
-    mRenderer->Draw();
+void Game::GenerateOutput(float alpha) {
+    PROFILE_SCOPE("Game::GenerateOutput");
+    // Between two frames nothing is drawing, swap reloaded assets in
+    for (const auto &fileName: mAssetWatcher.TakeChanges()) {
+        mRenderer->ReloadAsset(fileName);
+    }
+    mRenderer->ApplyReloads();
+
+    // Camera blended like the meshes, or attached models lag behind it
+    if (mFPSActor) {
+        mFPSActor->UpdateView(alpha);
+    }
+    mRenderer->Draw(alpha);
 }
 
-void Game::AddActor(class Actor *actor) {
-    if (mUpdatingActors) {
-        mPendingActors.emplace_back(actor);
+ActorHandle Game::AddActor(class Actor *actor) {
+    // The actor needs its handle right away so the add can't be deferred, and registry/entity storage
+    // aren't thread safe. Stop here rather than race
+    if (IsInParallelUpdate()) {
+        SDL_Log("Actor created during parallel update, spawn it through Game::Defer instead");
+        std::abort();
     }
-    else {
-        mActors.emplace_back(actor);
+    return mActors.Add(actor);
+}
+
+void Game::OnActorStateChanged(Actor *actor) {
+    if (mUpdatingActors) {
+        mPendingStateChanges.emplace_back(actor->GetHandle());
+    } else {
+        mActors.SetBucket(actor->GetHandle(), actor->GetState());
     }
 }
 
-void Game::RemoveActor(class Actor *actor) {
-    // Check pending and normal actor
-    // Swap to end of vector and pop off (avoid erase copies)
+void Game::AddInputActor(Actor *actor) {
+    mInputActors.emplace_back(actor);
+}
 
-    auto iter = std::find(mPendingActors.begin(), mPendingActors.end(), actor);
-    if (iter != mPendingActors.end()) {
-        std::iter_swap(iter, mPendingActors.end() - 1);
-        mPendingActors.pop_back();
+void Game::RemoveInputActor(Actor *actor) {
+    // Keep dispatch order, list is short
+    auto iter = std::find(mInputActors.begin(), mInputActors.end(), actor);
+    if (iter != mInputActors.end()) {
+        mInputActors.erase(iter);
     }
+}
 
-    iter = std::find(mActors.begin(), mActors.end(), actor);
-    if (iter != mActors.end()) {
-        std::iter_swap(iter, mActors.end() - 1);
-        mActors.pop_back();
+void Game::Defer(CommandBuffer::Command command) {
+    if (mCommands.IsRecording()) {
+        mCommands.Record(std::move(command));
+    } else {
+        command();
     }
 }
 
+void Game::ReserveActors(size_t count) {
+    mActors.Reserve(count);
+    mEntities.ReserveTransforms(count);
+}
+
+void Game::RemoveActor(class Actor *actor) {
+    // Slot lookup by handle, registry swaps the last actor into the hole
+    mActors.Remove(actor->GetHandle());
+}
+
 void Game::AddPlane(PlaneActor *plane) {
     mPlanes.emplace_back(plane);
 }
@@ -249,108 +401,37 @@ void Game::LoadData() {
     LoadText("Assets/English.gptext");
     // LoadText("Assets/Russian.gptext");
 
-    // Create actors
-    auto* a = new Actor(this);
-    a->SetPosition(Vector3(200.0f, 75.0f, 0.0f));
-    a->SetScale(100.0f);
-
-    Quaternion q(Vector3::UnitY, -Math::PiOver2);
-    q = Quaternion::Concatenate(q, Quaternion(Vector3::UnitZ, Math::Pi + Math::Pi / 4.0f));
-    a->SetRotation(q);
-    auto* mc = new MeshComponent(a);
-    mc->SetMesh(mRenderer->GetMesh("Assets/Cube.gpmesh"));
-
-    a = new Actor(this);
-    a->SetPosition(Vector3(200.0f, -75.0f, 0.0f));
-    a->SetScale(3.0f);
-    mc = new MeshComponent(a);
-    mc->SetMesh(mRenderer->GetMesh("Assets/Sphere.gpmesh"));
-
-    // Setup floor
-    const float start = -1250.0f;
-    const float size = 250.0f;
-    for (int i = 0; i < 10; i++) {
-        for (int j = 0; j < 10; j++) {
-            a = new PlaneActor(this);
-            a->SetPosition(Vector3(start + i * size, start + j * size, -100.0f));
-        }
-    }
-
-    // Left/right walls
-    q = Quaternion(Vector3::UnitX, Math::PiOver2);
-    for (int i = 0; i < 10; i++) {
-        a = new PlaneActor(this);
-        a->SetPosition(Vector3(start + i * size, start - size, 0.0f));
-        a->SetRotation(q);
-
-        a = new PlaneActor(this);
-        a->SetPosition(Vector3(start + i * size, -start + size, 0.0f));
-        a->SetRotation(q);
-    }
-
-    q = Quaternion::Concatenate(q, Quaternion(Vector3::UnitZ, Math::PiOver2));
-    // Forward/back walls
-    for (int i = 0; i < 10; i++) {
-        a = new PlaneActor(this);
-        a->SetPosition(Vector3(start - size, start + i * size, 0.0f));
-        a->SetRotation(q);
-
-        a = new PlaneActor(this);
-        a->SetPosition(Vector3(-start + size, start + i * size, 0.0f));
-        a->SetRotation(q);
-    }
-
-    // Setup lights
-    mRenderer->SetAmbientLight(Vector3(0.2f, 0.2f, 0.2f));
-    DirectionalLight& dir = mRenderer->GetDirectionalLight();
-    dir.mDirection = Vector3(0.0f, -0.707f, -0.707f);
-    dir.mDiffuseColor = Vector3(0.78f, 0.88f, 1.0f);
-    dir.mSpecColor = Vector3(0.8f, 0.8f, 0.8f);
+    // Level actors, lights and their assets
+    LoadLevel("Assets/Arena.gplevel");
 
-    // UI elements
+    // UI elements, their images are packed together first
+    mRenderer->LoadAtlas("Assets/UI.gpatlas");
     mHUD = new HUD(this);
 
     // Start music
     mMusicEvent = mAudioSystem->PlayEvent("event:/Music");
 
-    // Create spheres with audio components playing different sounds
-    a = new Actor(this);
-    a->SetPosition(Vector3(500.0f, -75.0f, 0.0f));
-    a->SetScale(1.0f);
-    mc = new MeshComponent(a);
-    mc->SetMesh(mRenderer->GetMesh("Assets/Sphere.gpmesh"));
-    auto* ac = new AudioComponent(a);
-    ac->PlayEvent("event:/FireLoop");
-
     // Camera actor ------------------------------------------------
     mFPSActor = new FPSActor(this);
     // mFollowActor = new FollowActor(this);
     // mOrbitActor = new OrbitActor(this);
     // mSplineActor = new SplineActor(this);
 
-    // Create target actors
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(1450.0f, 0.0f, 100.0f));
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(1450.0f, 0.0f, 400.0f));
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(1450.0f, -500.0f, 200.0f));
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(1450.0f, 500.0f, 200.0f));
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(0.0f, -1450.0f, 200.0f));
-    a->SetRotation(Quaternion(Vector3::UnitZ, Math::PiOver2));
-    a = new TargetActor(this);
-    a->SetPosition(Vector3(0.0f, 1450.0f, 200.0f));
-    a->SetRotation(Quaternion(Vector3::UnitZ, -Math::PiOver2));
-
+    // First cells of a streamed level are there before the first frame
+    mWorldStreamer->LoadAround(mFPSActor->GetPosition());
 }
 
 void Game::UnloadData() {
+    // Background loads hold renderer objects
+    if (mWorldStreamer) {
+        mWorldStreamer->Clear();
+    }
+
     // Because ~Actor calls RemoveActor, have to use a different style loop
-    while (!mActors.empty()) {
-        delete mActors.back();
+    while (!mActors.Empty()) {
+        delete mActors.GetActors().back();
     }
+    ObjectPool::LogStats();  // anything still live here is a leak
 
     // Remember to unload renderer data
     if (mRenderer) {
@@ -379,6 +460,11 @@ Font *Game::GetFont(const std::string &fileName) {
     }
 }
 
+bool Game::LoadLevel(const std::string &fileName) {
+    LevelLoader loader(this);
+    return loader.Load(fileName);
+}
+
 void Game::LoadText(const std::string &fileName) {
     // Clear the existing map, if already loaded
     mText.clear();
@@ -440,6 +526,10 @@ void Game::HandleGameKeyPress(const InputState& key) {
         volume = fmin(1.0f, volume + 0.1f);
         mAudioSystem->SetBusVolume("bus:/", volume);
     }
+    else if (key.Keyboard.GetKeyState(SDL_SCANCODE_F9) == EPressed) {
+        // Dump CPU profile, open in chrome://tracing or ui.perfetto.dev
+        Profiler::WriteChromeTrace(PROFILE_TRACE_FILE);
+    }
     else if (key.Keyboard.GetKeyState(SDL_SCANCODE_E) == EPressed) {
         // Play explosion
         mAudioSystem->PlayEvent("event:/Explosion2D");
@@ -6,6 +6,13 @@
 #include <string>
 #include "audio/SoundEvent.hpp"
 #include "core/InputSystem.hpp"
+#include "core/InputRecorder.hpp"
+#include "helper/FrameLimiter.hpp"
+#include "actors/ActorRegistry.hpp"
+#include "core/EntityStorage.hpp"
+#include "core/JobSystem.hpp"
+#include "core/CommandBuffer.hpp"
+#include "core/AssetWatcher.hpp"
 
 using std::vector;
 
@@ -13,20 +20,37 @@ class Game {
 public:
     Game();
 
-    // Core functions
-    bool Initialize();
+    // Core functions, headless creates no window, GL context or FMOD system
+    bool Initialize(bool headless = false);
     void RunLoop();
     void Shutdown();
 
-    // Create or delete actors
-    void AddActor(class Actor* actor);
+    // Create or delete actors, O(1) through the actor registry
+    ActorHandle AddActor(class Actor* actor);
     void RemoveActor(class Actor* actor);
+    // Room for count more actors before creating a batch (level load)
+    void ReserveActors(size_t count);
+    // Keep the active/paused/dead lists in sync, called by Actor::SetState
+    void OnActorStateChanged(class Actor* actor);
+    // Actors in the input dispatch list, managed by Actor::SetInputEnabled/Component::SetInputEnabled
+    void AddInputActor(class Actor* actor);
+    void RemoveInputActor(class Actor* actor);
+    // Return nullptr if the actor was deleted
+    [[nodiscard]] class Actor* GetActor(ActorHandle handle) const { return mActors.Get(handle); }
+
+    // Run a structural change (spawn, delete, audio, ...) on the main thread. During parallel actor update
+    // it's queued and played back after all actors finished, otherwise it runs right away
+    void Defer(CommandBuffer::Command command);
+    [[nodiscard]] bool IsInParallelUpdate() const { return mCommands.IsRecording(); }
 
     // Core Getter
     class Renderer* GetRenderer() { return mRenderer; }
     class AudioSystem* GetAudioSystem() { return mAudioSystem; }
     class InputSystem* GetInputSystem() { return mInputSystem; }
     class PhysWorld* GetPhysWorld() { return mPhysWorld; }
+    EntityStorage& GetEntityStorage() { return mEntities; }
+    JobSystem& GetJobSystem() { return mJobSystem; }
+    class WorldStreamer* GetWorldStreamer() { return mWorldStreamer; }
 
     enum GameState {
         EGameplay,
@@ -38,6 +62,34 @@ public:
     [[nodiscard]] GameState GetState() const { return mGameState; }
     void SetState(GameState state) { mGameState = state; }
 
+    // Fixed timestep simulation, rendering runs independently and interpolates between steps
+    void SetSimulationRate(float hz) { mFixedDeltaTime = 1.0f / hz; }
+    void SetMaxSimSteps(int steps) { mMaxSimSteps = steps; }
+    [[nodiscard]] float GetFixedDeltaTime() const { return mFixedDeltaTime; }
+
+    // Frame rate cap (<= 0 for uncapped) and pacing statistics
+    void SetFrameRateLimit(float hz) { mFrameLimiter.SetTargetRate(hz); }
+    [[nodiscard]] const FrameLimiter& GetFrameLimiter() const { return mFrameLimiter; }
+
+    // Run one simulation step per loop as fast as possible (benchmarks, servers)
+    void SetFastForward(bool value);
+    // Quit after this much simulated time in second, <= 0 runs until quit
+    void SetRunDuration(float seconds) { mRunDuration = seconds; }
+    [[nodiscard]] bool IsHeadless() const { return mHeadless; }
+
+    // Record or replay input + RNG seed for reproducible sessions, set before Initialize
+    void SetRecordFile(const std::string& fileName) { mRecordFile = fileName; }
+    void SetReplayFile(const std::string& fileName) { mReplayFile = fileName; }
+    // Job system worker threads besides the main thread, 0 for one per extra core. Set before Initialize
+    void SetWorkerCount(unsigned int count) { mWorkerCount = count; }
+    // Reload meshes, textures and shaders when their file changes. Set before Initialize
+    void SetHotReload(bool value) { mHotReload = value; }
+    // Lay down depth before shading meshes, trades vertex work for less overdraw. Set before Initialize
+    void SetDepthPrepass(bool value) { mDepthPrepass = value; }
+
+    // Load a level file (.gplevel), its cooked binary is used when up to date
+    bool LoadLevel(const std::string& fileName);
+
     // ui functions
     class Font* GetFont(const std::string& fileName);
     void LoadText(const std::string& fileName);
@@ -60,17 +112,26 @@ public:
 private:
     // Helper functions for the game loop
     void ProcessInput();
-    void UpdateGame();
-    void GenerateOutput();
+    void UpdateGame(float deltaTime);
+    void GenerateOutput(float alpha);
 
     // Responsible to create/delete all the actors in the game world
     void LoadData();
     void UnloadData();
 
-    // All the actors in the game, you need mPending when you're iterating over mActors and create a new one
-    vector<class Actor*> mActors;
-    vector<class Actor*> mPendingActors;
-    bool mUpdatingActors = false;  // Track if we're updating actors right now
+    // All the actors in the game. Actors created while iterating are appended to the end,
+    // so loops iterate a snapshot of the count and new actors start next frame
+    ActorRegistry mActors;
+    EntityStorage mEntities;  // SoA transform, motion and box data of the actors
+    // State changes during the serial update loop, moved between lists after it
+    bool mUpdatingActors = false;
+    std::vector<ActorHandle> mPendingStateChanges;
+    // Only these get ProcessInput, in registration order
+    std::vector<class Actor*> mInputActors;
+    // Actors with parallel update flag, gathered every step
+    std::vector<class Actor*> mParallelActors;
+    CommandBuffer mCommands;
+    constexpr static uint32_t PARALLEL_UPDATE_BATCH = 32;  // actors per job
 
     // ui
     std::unordered_map<std::string, class Font*> mFonts;  // filename -> ptr
@@ -96,15 +157,40 @@ private:
     class InputSystem* mInputSystem = nullptr;  // Input system
     class PhysWorld* mPhysWorld = nullptr;
     class Renderer* mRenderer = nullptr;
+    class WorldStreamer* mWorldStreamer = nullptr;  // cells of streamed levels around the player
 
     GameState mGameState = EGameplay;  // substitute naive isRunning to mGameState
-    Uint32 mTicksCount = 0;
+    FrameLimiter mFrameLimiter;  // sleep + spin limiter, also measures frame time
+    JobSystem mJobSystem;  // shared thread pool, main thread joins in when waiting
+    unsigned int mWorkerCount = 0;
+
+    // Fixed timestep accumulator
+    float mFixedDeltaTime = 1.0f / 60.0f;  // length of a simulation step in second
+    int mMaxSimSteps = 5;  // max catch up steps per frame before we drop time
+    float mAccumulator = 0;  // unsimulated time carried to next frame
+
+    bool mHeadless = false;  // null renderer & audio
+    bool mFastForward = false;  // ignore real time, no frame cap
+    float mRunDuration = 0;
+    float mSimulatedTime = 0;
+
+    // Watch asset/shader folders, changes are applied between frames
+    AssetWatcher mAssetWatcher;
+    bool mHotReload = false;
+
+    bool mDepthPrepass = false;
+
+    // Input record/replay
+    InputRecorder mInputRecorder;
+    std::string mRecordFile;
+    std::string mReplayFile;
 
 public:
     // Useful constant
     constexpr static int SCREEN_WIDTH = 1024;
     constexpr static int SCREEN_HEIGHT = 768;
     static std::string PROJECT_BASE;
+    constexpr static const char* PROFILE_TRACE_FILE = "profile.json";
 };
 
 
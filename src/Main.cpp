@@ -1,9 +1,41 @@
+#include <cstdlib>
+#include <cstring>
 #include "Game.hpp"
 
-int main() {
+int main(int argc, char* argv[]) {
     Game game{};
 
-    bool success = game.Initialize();
+    // Command line options
+    // --headless         no window, GL context or audio device
+    // --fast-forward     simulate as fast as possible, no frame cap
+    // --duration <sec>   quit after this much simulated time
+    // --record <file>    record input of every simulation step
+    // --replay <file>    replay recorded input instead of devices, quit when it ends
+    // --workers <n>      job system worker threads, default one per extra core
+    // --hot-reload       reload meshes, textures and shaders when their file changes
+    // --depth-prepass    draw mesh depth first, then shade each pixel once
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--fast-forward") == 0) {
+            game.SetFastForward(true);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            game.SetRunDuration(static_cast<float>(atof(argv[++i])));
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            game.SetRecordFile(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            game.SetReplayFile(argv[++i]);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            game.SetWorkerCount(static_cast<unsigned int>(atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--hot-reload") == 0) {
+            game.SetHotReload(true);
+        } else if (strcmp(argv[i], "--depth-prepass") == 0) {
+            game.SetDepthPrepass(true);
+        }
+    }
+
+    bool success = game.Initialize(headless);
     if (success) {
         game.RunLoop();
     }
@@ -2,33 +2,69 @@
 #include "../Game.hpp"
 #include "../components/Component.hpp"
 #include "../core/InputSystem.hpp"
+#include "../helper/PoolAllocator.hpp"
 
-Actor::Actor(Game *game) : mGame(game) {
-    mGame->AddActor(this);
+Actor::Actor(Game *game) : mGame(game), mStorage(&game->GetEntityStorage()) {
+    mHandle = mGame->AddActor(this);
+    mStorage->AddTransform(mHandle.mIndex, this);
 }
 
 Actor::~Actor() {
     mGame->RemoveActor(this);
+    mInputEnabled = false;
+    mInputComponents.clear();
+    UpdateInputRegistration();
 
     // Need to delete components, because ~Component calls RemoveComponent, need a different style loop
     while (!mComponents.empty()) {
         delete mComponents.back();
     }
+    mStorage->RemoveTransform(mHandle.mIndex);
+}
+
+void *Actor::operator new(size_t size) {
+    return ObjectPool::Allocate(size);
+}
+
+void Actor::operator delete(void *ptr, size_t size) {
+    // Size of the most derived type thanks to virtual destructor
+    ObjectPool::Free(ptr, size);
 }
 
 void Actor::Update(float deltaTime) {
+    // Previous transform and MoveComponent integration are done in EntityStorage before this
     if (mState == EActive) {
-        ComputeWorldTransform();
         UpdateComponents(deltaTime);
         UpdateActor(deltaTime);
-        ComputeWorldTransform();
     }
 }
 
 void Actor::UpdateComponents(float deltaTime) {
-    for (auto comp: mComponents) {
-        comp->Update(deltaTime);
+    // Index loop, a component can enable/disable ticking (or be deleted) while we update
+    mUpdatingComponents = true;
+    for (size_t i = 0; i < mTickComponents.size(); i++) {
+        if (mTickComponents[i]) {
+            mTickComponents[i]->Update(deltaTime);
+        }
     }
+    mUpdatingComponents = false;
+
+    mTickComponents.erase(std::remove(mTickComponents.begin(), mTickComponents.end(), nullptr),
+                          mTickComponents.end());
+    for (auto comp: mPendingTickComponents) {
+        AddTickComponent(comp);
+    }
+    mPendingTickComponents.clear();
+}
+
+void Actor::SetState(State state) {
+    if (mGame->IsInParallelUpdate()) {
+        mGame->Defer([this, state]() { SetState(state); });
+        return;
+    }
+    mState = state;
+    Transforms().mActive[Row()] = mState == EActive;
+    mGame->OnActorStateChanged(this);
 }
 
 void Actor::UpdateActor(float deltaTime) {
@@ -38,10 +74,12 @@ void Actor::UpdateActor(float deltaTime) {
 void Actor::ProcessInput(const InputState &keyState) {
     // process input for components, then actor specific
     if (mState == EActive) {
-        for (auto comp: mComponents) {
+        for (auto comp: mInputComponents) {
             comp->ProcessInput(keyState);
         }
-        ActorInput(keyState);
+        if (mInputEnabled) {
+            ActorInput(keyState);
+        }
     }
 }
 
@@ -49,19 +87,41 @@ void Actor::ActorInput(const InputState &keyState) {
     // Actor specific input
 }
 
+void Actor::SetInputEnabled(bool value) {
+    mInputEnabled = value;
+    UpdateInputRegistration();
+}
+
+void Actor::UpdateInputRegistration() {
+    bool wanted = mInputEnabled || !mInputComponents.empty();
+    if (wanted == mInputRegistered) {
+        return;
+    }
+    mInputRegistered = wanted;
+    if (mInputRegistered) {
+        mGame->AddInputActor(this);
+    } else {
+        mGame->RemoveInputActor(this);
+    }
+}
+
 void Actor::AddComponent(Component *component) {
+    InsertByUpdateOrder(mComponents, component);
+}
+
+void Actor::InsertByUpdateOrder(vector<Component *> &components, Component *component) {
     // Find the insertion point in the sorted vector
     // (The first element with an order higher than me)
     int myOrder = component->GetUpdateOrder();
-    auto iter = mComponents.begin();
-    while (iter != mComponents.end()) {
+    auto iter = components.begin();
+    while (iter != components.end()) {
         if (myOrder < (*iter)->GetUpdateOrder())
             break;
         ++iter;
     }
 
     // Inserts element before position of iterator
-    mComponents.insert(iter, component);
+    components.insert(iter, component);
 }
 
 void Actor::RemoveComponent(Component *component) {
@@ -71,22 +131,97 @@ void Actor::RemoveComponent(Component *component) {
     }
 }
 
-void Actor::ComputeWorldTransform() {
-    if (mRecomputeWorldTransform) {
-        mRecomputeWorldTransform = false;
+void Actor::SetParent(Actor *parent) {
+    mStorage->SetParent(mHandle.mIndex, parent ? parent->GetHandle().mIndex : TransformTable::NO_ENTITY);
+}
 
-        // Scale, then rotate, then translate
-        mWorldTransform = Matrix4::CreateScale(mScale);
-        mWorldTransform *= Matrix4::CreateFromQuaternion(mRotation);
-        mWorldTransform *= Matrix4::CreateTranslation(mPosition);
+Actor *Actor::GetParent() const {
+    uint32_t parent = Transforms().mParents[Row()];
+    if (parent == TransformTable::NO_ENTITY) {
+        return nullptr;
+    }
+    return Transforms().mActors[Transforms().mSet.GetRow(parent)];
+}
 
-        // Inform components world transform updated
-        for (auto comp: mComponents) {
-            comp->OnUpdateWorldTransform();
+void Actor::AddTickComponent(Component *component) {
+    if (mUpdatingComponents) {
+        mPendingTickComponents.emplace_back(component);
+        return;
+    }
+    InsertByUpdateOrder(mTickComponents, component);
+}
+
+void Actor::RemoveTickComponent(Component *component) {
+    auto pending = std::find(mPendingTickComponents.begin(), mPendingTickComponents.end(), component);
+    if (pending != mPendingTickComponents.end()) {
+        mPendingTickComponents.erase(pending);
+        return;
+    }
+
+    auto iter = std::find(mTickComponents.begin(), mTickComponents.end(), component);
+    if (iter != mTickComponents.end()) {
+        // Keep indices stable while updating, holes are removed afterwards
+        if (mUpdatingComponents) {
+            *iter = nullptr;
+        } else {
+            mTickComponents.erase(iter);
         }
     }
 }
 
+void Actor::AddInputComponent(Component *component) {
+    InsertByUpdateOrder(mInputComponents, component);
+    UpdateInputRegistration();
+}
+
+void Actor::RemoveInputComponent(Component *component) {
+    auto iter = std::find(mInputComponents.begin(), mInputComponents.end(), component);
+    if (iter != mInputComponents.end()) {
+        mInputComponents.erase(iter);
+    }
+    UpdateInputRegistration();
+}
+
+void Actor::ComputeWorldTransform() {
+    mStorage->UpdateWorldTransform(mHandle.mIndex);
+}
+
+void Actor::OnUpdateWorldTransform() {
+    for (auto comp: mComponents) {
+        comp->OnUpdateWorldTransform();
+    }
+}
+
+Vector3 Actor::GetPreviousPosition() const {
+    const TransformTable &t = Transforms();
+    uint32_t row = Row();
+    return t.mHasPrev[row] ? t.mPrevPositions[row] : t.mPositions[row];
+}
+
+Quaternion Actor::GetPreviousRotation() const {
+    const TransformTable &t = Transforms();
+    uint32_t row = Row();
+    return t.mHasPrev[row] ? t.mPrevRotations[row] : t.mRotations[row];
+}
+
+Matrix4 Actor::GetInterpolatedTransform(float alpha) const {
+    const TransformTable &t = Transforms();
+    uint32_t row = Row();
+    // Nothing to blend from, use current transform directly
+    if (!t.mHasPrev[row] || !t.mMoved[row] || alpha >= 1.0f) {
+        return t.mWorldTransforms[row];
+    }
+
+    // Blend local transform, then put it under the blended parent
+    Matrix4 transform = Matrix4::CreateTransform(Math::Lerp(t.mPrevScales[row], t.mScales[row], alpha),
+                                                 Quaternion::Slerp(t.mPrevRotations[row], t.mRotations[row], alpha),
+                                                 Vector3::Lerp(t.mPrevPositions[row], t.mPositions[row], alpha));
+    if (Actor *parent = GetParent()) {
+        transform *= parent->GetInterpolatedTransform(alpha);
+    }
+    return transform;
+}
+
 void Actor::RotateToNewForward(const Vector3 &forward) {
     // Figure out difference between original (unit x) and new
     float dot = Vector3::Dot(Vector3::UnitX, forward);
@@ -2,12 +2,15 @@
 
 #include <vector>
 #include "../helper/Math.hpp"
+#include "ActorRegistry.hpp"
+#include "../core/EntityStorage.hpp"
 
 using std::vector;
 
 class Actor {
 public:
     // Only update in Active state, Will remove in EDead.
+    // Values are also the actor list index in ActorRegistry buckets
     enum State {
         EActive, EPause, EDead
     };
@@ -16,58 +19,98 @@ public:
     explicit Actor(class Game *game);
     virtual ~Actor();
 
-    // Update called from game
+    // Actors come from per size pools, still created with new and freed with delete
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
+    // Update called from game, world transforms are rebuilt afterwards in one pass by EntityStorage
     void Update(float deltaTime);
-    // Update all components attached to this actor
+    // Update components attached to this actor that have ticking enabled
     void UpdateComponents(float deltaTime);
     // Any actor specific update code
     virtual void UpdateActor(float deltaTime);
 
-    // Process input for actor and components
+    // Process input for actor and components, game only calls it on actors that want input
     void ProcessInput(const struct InputState& keyState);
     virtual void ActorInput(const struct InputState& keyState);
-
-    // Setter
-    void SetPosition(const Vector3& pos) { mPosition = pos; mRecomputeWorldTransform = true; }
-    void SetScale(float scale) { mScale = scale; mRecomputeWorldTransform = true; }
-    void SetRotation(const Quaternion &rotation) { mRotation = rotation; mRecomputeWorldTransform = true; }
-    void SetState(State state) { mState = state; }
-
-    // Getter
-    [[nodiscard]] const Vector3& GetPosition() const { return mPosition; }
-    [[nodiscard]] float GetScale() const { return mScale; }
-    [[nodiscard]] const Quaternion& GetRotation() const { return mRotation; }
+    // ActorInput is only called after enabling it, components enable their own
+    void SetInputEnabled(bool value);
+
+    // Setter, transform lives in the game's entity storage and is relative to the parent
+    void SetPosition(const Vector3& pos) { Transforms().mPositions[Row()] = pos; MarkDirty(); }
+    void SetScale(float scale) { Transforms().mScales[Row()] = scale; MarkDirty(); }
+    void SetRotation(const Quaternion &rotation) { Transforms().mRotations[Row()] = rotation; MarkDirty(); }
+    // Deferred to the sync point when called during parallel update
+    void SetState(State state);
+    // Update on a worker thread. The actor must only write itself, read other actors through
+    // GetPrevious*/PhysWorld and make structural changes through Game::Defer
+    void SetParallelUpdate(bool value) { mParallelUpdate = value; }
+
+    // Getter, return by value since storage rows move when entities are added or removed
+    [[nodiscard]] Vector3 GetPosition() const { return Transforms().mPositions[Row()]; }
+    [[nodiscard]] float GetScale() const { return Transforms().mScales[Row()]; }
+    [[nodiscard]] Quaternion GetRotation() const { return Transforms().mRotations[Row()]; }
     [[nodiscard]] State GetState() const { return mState; }
-    [[nodiscard]] const Matrix4& GetWorldTransform() const { return mWorldTransform; }
+    [[nodiscard]] Matrix4 GetWorldTransform() const { return Transforms().mWorldTransforms[Row()]; }
+    [[nodiscard]] Vector3 GetWorldPosition() const { return GetWorldTransform().GetTranslation(); }
+    // World transform blended between previous and current simulation step, alpha in [0, 1]
+    [[nodiscard]] Matrix4 GetInterpolatedTransform(float alpha) const;
+    [[nodiscard]] ActorHandle GetHandle() const { return mHandle; }
+    [[nodiscard]] bool IsParallelUpdate() const { return mParallelUpdate; }
+    // Transform at the start of current step, safe to read while other actors update in parallel
+    [[nodiscard]] Vector3 GetPreviousPosition() const;
+    [[nodiscard]] Quaternion GetPreviousRotation() const;
     class Game* GetGame() { return mGame; }
 
     // Computation property
-    [[nodiscard]] Vector3 GetForward() const { return Vector3::Transform(Vector3::UnitX, mRotation); }
-    [[nodiscard]] Vector3 GetRight() const { return Vector3::Transform(Vector3::UnitY, mRotation); }
+    [[nodiscard]] Vector3 GetForward() const { return Vector3::Transform(Vector3::UnitX, GetRotation()); }
+    [[nodiscard]] Vector3 GetRight() const { return Vector3::Transform(Vector3::UnitY, GetRotation()); }
+
+    // Hierarchy, child follows the parent without per frame copying. nullptr detaches
+    void SetParent(Actor* parent);
+    [[nodiscard]] Actor* GetParent() const;
 
     // Helper function
+    // Recompute world transform now if dirty (normally done at end of step)
     void ComputeWorldTransform();
+    // Inform components world transform updated
+    void OnUpdateWorldTransform();
     void RotateToNewForward(const Vector3& forward);
 
     // Add/remove component
     void AddComponent(class Component* component);
     void RemoveComponent(class Component* component);
+    // Components that want Update, see Component::SetTickEnabled
+    void AddTickComponent(class Component* component);
+    void RemoveTickComponent(class Component* component);
+    // Components that want ProcessInput, see Component::SetInputEnabled
+    void AddInputComponent(class Component* component);
+    void RemoveInputComponent(class Component* component);
 
 private:
+    // Row of this actor in the transform table
+    TransformTable& Transforms() const { return mStorage->GetTransforms(); }
+    [[nodiscard]] uint32_t Row() const { return mStorage->GetTransforms().mSet.GetRow(mHandle.mIndex); }
+    void MarkDirty() { Transforms().mDirty[Row()] = 1; }  // when our transform change we need to recalculate
+    static void InsertByUpdateOrder(vector<class Component*>& components, class Component* component);
+    // Register in game's input dispatch list while the actor or any component wants input
+    void UpdateInputRegistration();
+
     // Actor state
     State mState = EActive;
-    bool mRecomputeWorldTransform = true;  // when our transform change we need to recalculate
-
-    // Transform
-    Matrix4 mWorldTransform;
-    Vector3 mPosition = Vector3::Zero;  // Centre position
-    Quaternion mRotation = Quaternion::Identity;  // Rotation in Quaternion
-    float mScale = 1;  // Uniform scale of actor
+    bool mParallelUpdate = false;
 
     // Components
     vector<class Component*> mComponents;
+    vector<class Component*> mTickComponents;  // sorted by update order, nullptr if removed while updating
+    vector<class Component*> mPendingTickComponents;  // added while updating, merged after
+    vector<class Component*> mInputComponents;  // sorted by update order like mComponents
+    bool mUpdatingComponents = false;
+
+    // Input
+    bool mInputEnabled = false;  // ActorInput wanted
+    bool mInputRegistered = false;  // in game's input list
     class Game *mGame;
+    class EntityStorage *mStorage;
+    ActorHandle mHandle;  // slot in game's actor registry, also our entity id in storage
 };
-
-
-
@@ -0,0 +1,104 @@
+#include "ActorRegistry.hpp"
+
+ActorHandle ActorRegistry::Add(Actor *actor) {
+    // Reuse a free slot if any, otherwise grow
+    uint32_t slotIndex;
+    if (mFreeHead != INVALID_INDEX) {
+        slotIndex = mFreeHead;
+        mFreeHead = mSlots[slotIndex].mNextFree;
+    } else {
+        slotIndex = static_cast<uint32_t>(mSlots.size());
+        mSlots.emplace_back();
+    }
+
+    Slot &slot = mSlots[slotIndex];
+    slot.mDenseIndex = static_cast<uint32_t>(mDense.size());
+    slot.mNextFree = INVALID_INDEX;
+    mDense.emplace_back(actor);
+    mDenseToSlot.emplace_back(slotIndex);
+    AddToBucket(slotIndex, 0);
+
+    return {slotIndex, slot.mGeneration};
+}
+
+void ActorRegistry::Reserve(size_t count) {
+    size_t total = mDense.size() + count;
+    mSlots.reserve(total);
+    mDense.reserve(total);
+    mDenseToSlot.reserve(total);
+    mBuckets[0].mActors.reserve(mBuckets[0].mActors.size() + count);
+    mBuckets[0].mSlots.reserve(mBuckets[0].mSlots.size() + count);
+}
+
+void ActorRegistry::Remove(ActorHandle handle) {
+    if (Get(handle) == nullptr) {
+        return;
+    }
+
+    RemoveFromBucket(handle.mIndex);
+
+    // Move last actor into the removed position
+    Slot &slot = mSlots[handle.mIndex];
+    uint32_t hole = slot.mDenseIndex;
+    uint32_t last = static_cast<uint32_t>(mDense.size()) - 1;
+    if (hole != last) {
+        mDense[hole] = mDense[last];
+        mDenseToSlot[hole] = mDenseToSlot[last];
+        mSlots[mDenseToSlot[hole]].mDenseIndex = hole;
+    }
+    mDense.pop_back();
+    mDenseToSlot.pop_back();
+
+    // Invalidate outstanding handles (skip 0 on wrap around) and free slot
+    if (++slot.mGeneration == 0) {
+        slot.mGeneration = 1;
+    }
+    slot.mDenseIndex = INVALID_INDEX;
+    slot.mNextFree = mFreeHead;
+    mFreeHead = handle.mIndex;
+}
+
+Actor *ActorRegistry::Get(ActorHandle handle) const {
+    if (handle.mIndex >= mSlots.size()) {
+        return nullptr;
+    }
+
+    const Slot &slot = mSlots[handle.mIndex];
+    if (slot.mGeneration != handle.mGeneration || slot.mDenseIndex == INVALID_INDEX) {
+        return nullptr;
+    }
+    return mDense[slot.mDenseIndex];
+}
+
+void ActorRegistry::SetBucket(ActorHandle handle, uint8_t bucket) {
+    if (Get(handle) == nullptr || mSlots[handle.mIndex].mBucket == bucket) {
+        return;
+    }
+    RemoveFromBucket(handle.mIndex);
+    AddToBucket(handle.mIndex, bucket);
+}
+
+void ActorRegistry::AddToBucket(uint32_t slotIndex, uint8_t bucket) {
+    Slot &slot = mSlots[slotIndex];
+    Bucket &b = mBuckets[bucket];
+    slot.mBucket = bucket;
+    slot.mBucketIndex = static_cast<uint32_t>(b.mActors.size());
+    b.mActors.emplace_back(mDense[slot.mDenseIndex]);
+    b.mSlots.emplace_back(slotIndex);
+}
+
+void ActorRegistry::RemoveFromBucket(uint32_t slotIndex) {
+    // Same swap and pop as the dense array
+    Slot &slot = mSlots[slotIndex];
+    Bucket &b = mBuckets[slot.mBucket];
+    uint32_t hole = slot.mBucketIndex;
+    uint32_t last = static_cast<uint32_t>(b.mActors.size()) - 1;
+    if (hole != last) {
+        b.mActors[hole] = b.mActors[last];
+        b.mSlots[hole] = b.mSlots[last];
+        mSlots[b.mSlots[hole]].mBucketIndex = hole;
+    }
+    b.mActors.pop_back();
+    b.mSlots.pop_back();
+    slot.mBucketIndex = INVALID_INDEX;
+}
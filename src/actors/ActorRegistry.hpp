@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Weak reference to an actor, becomes stale (instead of dangling) when the actor is deleted
+struct ActorHandle {
+    uint32_t mIndex = 0;
+    uint32_t mGeneration = 0;  // 0 is never a live generation, default handle is null
+
+    [[nodiscard]] bool IsNull() const { return mGeneration == 0; }
+    bool operator==(const ActorHandle& other) const {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+    }
+    bool operator!=(const ActorHandle& other) const { return !(*this == other); }
+};
+
+// Slot map of actors, O(1) add/remove/lookup and a dense array for iteration.
+// Every actor is also in one bucket list (Actor::State), so loops only visit the state they need
+class ActorRegistry {
+public:
+    constexpr static uint8_t NUM_BUCKETS = 3;
+
+    ActorHandle Add(class Actor* actor);
+    // Room for count more actors, so adding a batch doesn't reallocate
+    void Reserve(size_t count);
+    // Swap the last actor into the hole, so dense order changes on remove
+    void Remove(ActorHandle handle);
+
+    // Return nullptr if the handle is stale or null
+    [[nodiscard]] class Actor* Get(ActorHandle handle) const;
+
+    // Move to another bucket in O(1), swap removes so bucket order changes. New actors are in bucket 0
+    void SetBucket(ActorHandle handle, uint8_t bucket);
+    [[nodiscard]] const std::vector<class Actor*>& GetBucket(uint8_t bucket) const { return mBuckets[bucket].mActors; }
+
+    // Getter
+    [[nodiscard]] const std::vector<class Actor*>& GetActors() const { return mDense; }
+    [[nodiscard]] size_t Size() const { return mDense.size(); }
+    [[nodiscard]] bool Empty() const { return mDense.empty(); }
+
+private:
+    constexpr static uint32_t INVALID_INDEX = UINT32_MAX;
+
+    struct Slot {
+        uint32_t mGeneration = 1;
+        uint32_t mDenseIndex = INVALID_INDEX;  // position in mDense if alive
+        uint32_t mNextFree = INVALID_INDEX;  // free list link if dead
+        uint32_t mBucketIndex = INVALID_INDEX;  // position in its bucket
+        uint8_t mBucket = 0;
+    };
+
+    struct Bucket {
+        std::vector<class Actor*> mActors;
+        std::vector<uint32_t> mSlots;  // bucket index -> slot index
+    };
+
+    void AddToBucket(uint32_t slotIndex, uint8_t bucket);
+    void RemoveFromBucket(uint32_t slotIndex);
+
+    std::vector<Slot> mSlots;
+    std::vector<class Actor*> mDense;  // contiguous live actors
+    std::vector<uint32_t> mDenseToSlot;  // dense index -> slot index
+    uint32_t mFreeHead = INVALID_INDEX;
+    Bucket mBuckets[NUM_BUCKETS];
+};
@@ -8,6 +8,7 @@
 
 BallActor::BallActor(Game *game) : Actor(game) {
     //SetScale(10.0f);
+    SetParallelUpdate(true);  // only touches itself, collision query and deferred audio
 
     // Render
     auto *mc = new MeshComponent(this);
@@ -7,6 +7,7 @@
 #include "../Game.hpp"
 
 CameraActor::CameraActor(Game *game) : Actor(game) {
+    SetInputEnabled(true);
     mMoveComp = new MoveComponent(this);
 }
 
@@ -13,6 +13,7 @@
 #include "../components/collision/BoxComponent.hpp"
 
 FPSActor::FPSActor(Game* game) : Actor(game) {
+    SetInputEnabled(true);
     // Relative for FPS mode
     game->GetInputSystem()->SetRelativeMouseMode(true);
 
@@ -24,7 +25,10 @@ FPSActor::FPSActor(Game* game) : Actor(game) {
 
     mCameraComp = new FPSCamera(this);
 
+    // Model is a child, offset a little bit to the right of the camera and follow it for free
     mFPSModel = new Actor(game);
+    mFPSModel->SetParent(this);
+    mFPSModel->SetPosition(Vector3(10.0f, 10.0f, -10.0f));
     mFPSModel->SetScale(0.75f);
     mMeshComp = new MeshComponent(mFPSModel);
     mMeshComp->SetMesh(game->GetRenderer()->GetMesh("Assets/Rifle.gpmesh"));
@@ -49,18 +53,12 @@ void FPSActor::UpdateActor(float deltaTime) {
         mLastFootstep = 0.5f;
     }
 
-    // Update position of FPS model relative to actor position (little bit to the right)
-    const Vector3 modelOffset(Vector3(10.0f, 10.0f, -10.0f));
-    Vector3 modelPos = GetPosition();
-    modelPos += GetForward() * modelOffset.x;
-    modelPos += GetRight() * modelOffset.y;
-    modelPos.z += modelOffset.z;
-    mFPSModel->SetPosition(modelPos);
-    // Initialize rotation to actor rotation
-    Quaternion q = GetRotation();
-    // Rotate by pitch from camera
-    q = Quaternion::Concatenate(q, Quaternion(GetRight(), mCameraComp->GetPitch()));
-    mFPSModel->SetRotation(q);
+    // Only the pitch from camera is local to the model, position and yaw come from parent
+    float pitch = mCameraComp->GetPitch();
+    if (pitch != mModelPitch) {
+        mModelPitch = pitch;
+        mFPSModel->SetRotation(Quaternion(Vector3::UnitY, pitch));
+    }
 }
 
 void FPSActor::ActorInput(const InputState& state) {
@@ -127,15 +125,20 @@ void FPSActor::SetVisible(bool visible) {
     mMeshComp->SetVisible(visible);
 }
 
+void FPSActor::UpdateView(float alpha) {
+    mCameraComp->UpdateView(alpha);
+}
+
 void FPSActor::FixCollisions() {
     // Need to recompute my world transform to update world box
     ComputeWorldTransform();
 
-    const AABB &playerBox = mBoxComp->GetWorldBox();
     auto pos = GetPosition();
 
     auto &planes = GetGame()->GetPlanes();
     for (auto pa: planes) {
+        // Box is a copy, read it again after each correction
+        AABB playerBox = mBoxComp->GetWorldBox();
         // Do we collide with this PlaneActor?
         const AABB &planeBox = pa->GetBox()->GetWorldBox();
         if (Intersect(playerBox, planeBox)) {
@@ -14,6 +14,9 @@ public:
     void SetFootstepSurface(float value);
     void SetVisible(bool visible);
 
+    // Render camera between the last two steps
+    void UpdateView(float alpha);
+
     // Game
     void Shoot();
     void FixCollisions();
@@ -27,6 +30,7 @@ private:
     class Actor* mFPSModel = nullptr;
     SoundEvent mFootstep;
     float mLastFootstep;
+    float mModelPitch = 0;  // pitch the model rotation was built from
 };
 
 
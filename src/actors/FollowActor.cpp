@@ -6,6 +6,7 @@
 #include "../components/control/MoveComponent.hpp"
 
 FollowActor::FollowActor(Game *game) : Actor(game) {
+    SetInputEnabled(true);
     mMeshComp = new MeshComponent(this);
     mMeshComp->SetMesh(game->GetRenderer()->GetMesh("Assets/RacingCar.gpmesh"));
     SetPosition(Vector3(0.0f, 0.0f, -100.0f));
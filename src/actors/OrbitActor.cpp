@@ -6,6 +6,7 @@
 
 
 OrbitActor::OrbitActor(Game *game) : Actor(game) {
+    SetInputEnabled(true);
     game->GetInputSystem()->SetRelativeMouseMode(true);
 
     mMeshComp = new MeshComponent(this);
@@ -8,7 +8,8 @@
 PlaneActor::PlaneActor(Game* game) : Actor(game) {
 	SetScale(10.0f);
 	auto* mc = new MeshComponent(this);
-    auto* mesh = GetGame()->GetRenderer()->GetMesh("Assets/Plane.gpmesh");
+    auto* mesh = GetGame()->GetRenderer()->GetMesh(MESH_FILE);
+	mc->SetStatic(true);  // floor and walls never move
 	mc->SetMesh(mesh);
 
     // Add collision box
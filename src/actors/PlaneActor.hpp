@@ -9,6 +9,8 @@ public:
 
     class BoxComponent* GetBox() { return mBox; }
 
+    constexpr static const char* MESH_FILE = "Assets/Plane.gpmesh";
+
 private:
     class BoxComponent* mBox;
 };
\ No newline at end of file
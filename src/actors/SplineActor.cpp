@@ -5,6 +5,7 @@
 #include "../components/camera/SplineCamera.hpp"
 
 SplineActor::SplineActor(Game *game) : Actor(game) {
+    SetInputEnabled(true);
     // auto* mc = new MeshComponent(this);
     // mc->SetMesh(game->GetRenderer()->GetMesh("Assets/RacingCar.gpmesh"));
     // SetPosition(Vector3(0.0f, 0.0f, -100.0f));
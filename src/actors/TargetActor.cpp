@@ -8,9 +8,10 @@
 
 TargetActor::TargetActor(Game *game) : Actor(game) {
     //SetScale(10.0f);
+    SetParallelUpdate(true);  // static, nothing shared
     SetRotation(Quaternion(Vector3::UnitZ, Math::Pi));
     auto *mc = new MeshComponent(this);
-    Mesh *mesh = GetGame()->GetRenderer()->GetMesh("Assets/Target.gpmesh");
+    Mesh *mesh = GetGame()->GetRenderer()->GetMesh(MESH_FILE);
     mc->SetMesh(mesh);
 
     // Add collision box
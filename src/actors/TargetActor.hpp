@@ -4,4 +4,6 @@
 class TargetActor : public Actor {
 public:
 	explicit TargetActor(class Game* game);
+
+    constexpr static const char* MESH_FILE = "Assets/Target.gpmesh";
 };
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include "../Game.hpp"
+#include "../helper/Profiler.hpp"
 
 unsigned int AudioSystem::sNextID = 0;
 
@@ -57,6 +58,7 @@ void AudioSystem::Shutdown() {
 }
 
 void AudioSystem::Update(float deltaTime) {
+    PROFILE_SCOPE("AudioSystem::Update");
     // Find any stopped event instances and clean them up
     std::vector<unsigned int> done;
     for (auto &iter: mEventInstances) {
@@ -18,28 +18,28 @@ namespace FMOD {
 class AudioSystem {
 public:
     explicit AudioSystem(class Game* game);
-    ~AudioSystem() = default;
+    virtual ~AudioSystem() = default;
 
-    bool Initialize();
-    void Shutdown();
-    void Update(float deltaTime);
+    virtual bool Initialize();
+    virtual void Shutdown();
+    virtual void Update(float deltaTime);
 
     // Load/unload banks
-    void LoadBank(const std::string& name);
-    void UnloadBank(const std::string& name);
-    void UnloadAllBanks();
+    virtual void LoadBank(const std::string& name);
+    virtual void UnloadBank(const std::string& name);
+    virtual void UnloadAllBanks();
 
     // Play event, increment id and return sound wrapper
-    SoundEvent PlayEvent(const std::string& name);
+    virtual SoundEvent PlayEvent(const std::string& name);
 
     // For positional audio
-    void SetListener(const Matrix4& viewMatrix);
+    virtual void SetListener(const Matrix4& viewMatrix);
 
     // Control buses
-    [[nodiscard]] float GetBusVolume(const std::string& name) const;
-    [[nodiscard]] bool GetBusPaused(const std::string& name) const;
-    void SetBusVolume(const std::string& name, float volume);
-    void SetBusPaused(const std::string& name, bool pause);
+    [[nodiscard]] virtual float GetBusVolume(const std::string& name) const;
+    [[nodiscard]] virtual bool GetBusPaused(const std::string& name) const;
+    virtual void SetBusVolume(const std::string& name, float volume);
+    virtual void SetBusPaused(const std::string& name, bool pause);
 
 protected:
     // Prevent everybody from having access to event instance, but SoundEvent needed this
@@ -59,7 +59,7 @@ private:
     // Tracks the next ID to use for event instances
     static unsigned int sNextID;
 
-private:
+protected:
     // Core
     class Game* mGame;
     // FMOD studio system
@@ -0,0 +1,14 @@
+#include "NullAudioSystem.hpp"
+#include <SDL_log.h>
+
+NullAudioSystem::NullAudioSystem(Game *game) : AudioSystem(game) {}
+
+bool NullAudioSystem::Initialize() {
+    SDL_Log("Running with null audio system");
+    return true;
+}
+
+SoundEvent NullAudioSystem::PlayEvent(const std::string &name) {
+    // Invalid event, not associated with any system
+    return {};
+}
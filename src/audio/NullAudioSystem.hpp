@@ -0,0 +1,29 @@
+#pragma once
+
+#include "AudioSystem.hpp"
+
+// Audio system without FMOD, every event is invalid so SoundEvent calls are no-op
+class NullAudioSystem : public AudioSystem {
+public:
+    explicit NullAudioSystem(class Game* game);
+
+    bool Initialize() override;
+    void Shutdown() override {}
+    void Update(float deltaTime) override {}
+
+    void LoadBank(const std::string& name) override {}
+    void UnloadBank(const std::string& name) override {}
+    void UnloadAllBanks() override {}
+
+    SoundEvent PlayEvent(const std::string& name) override;
+    void SetListener(const Matrix4& viewMatrix) override {}
+
+    [[nodiscard]] float GetBusVolume(const std::string& name) const override { return mMasterVolume; }
+    [[nodiscard]] bool GetBusPaused(const std::string& name) const override { return false; }
+    void SetBusVolume(const std::string& name, float volume) override { mMasterVolume = volume; }
+    void SetBusPaused(const std::string& name, bool pause) override {}
+
+private:
+    // Keep volume around so volume key logic behaves the same
+    float mMasterVolume = 1.0f;
+};
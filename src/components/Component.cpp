@@ -1,6 +1,7 @@
 #include "Component.hpp"
 #include "../actors/Actor.hpp"
 #include "../core/InputSystem.hpp"
+#include "../helper/PoolAllocator.hpp"
 
 Component::Component(Actor *owner, int updateOrder)
         : mOwner(owner), mUpdateOrder(updateOrder) {
@@ -9,9 +10,19 @@ Component::Component(Actor *owner, int updateOrder)
 }
 
 Component::~Component() {
+    SetInputEnabled(false);
+    SetTickEnabled(false);
     mOwner->RemoveComponent(this);
 }
 
+void *Component::operator new(size_t size) {
+    return ObjectPool::Allocate(size);
+}
+
+void Component::operator delete(void *ptr, size_t size) {
+    ObjectPool::Free(ptr, size);
+}
+
 void Component::Update(float deltaTime) {
 
 }
@@ -19,3 +30,27 @@ void Component::Update(float deltaTime) {
 void Component::ProcessInput(const InputState &keyState) {
 
 }
+
+void Component::SetTickEnabled(bool value) {
+    if (value == mTickEnabled) {
+        return;
+    }
+    mTickEnabled = value;
+    if (mTickEnabled) {
+        mOwner->AddTickComponent(this);
+    } else {
+        mOwner->RemoveTickComponent(this);
+    }
+}
+
+void Component::SetInputEnabled(bool value) {
+    if (value == mInputEnabled) {
+        return;
+    }
+    mInputEnabled = value;
+    if (mInputEnabled) {
+        mOwner->AddInputComponent(this);
+    } else {
+        mOwner->RemoveInputComponent(this);
+    }
+}
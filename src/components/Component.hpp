@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SDL.h>
+#include <cstddef>
 
 class Component {
 public:
@@ -8,11 +9,18 @@ public:
     explicit Component(class Actor* owner, int updateOrder = 100);
     virtual ~Component();
 
-    // Update this component by delta time
+    // Components of the same type are packed in one pool instead of the general heap
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
+    // Update this component by delta time, only called after SetTickEnabled(true).
+    // Components overriding Update enable ticking in their constructor
     virtual void Update(float deltaTime);
+    void SetTickEnabled(bool value);
 
-    // Process input for components
+    // Process input for components, only called after SetInputEnabled(true)
     virtual void ProcessInput(const struct InputState& keyState);
+    void SetInputEnabled(bool value);
 
     // Notify when parent's being updated
     virtual void OnUpdateWorldTransform() {};
@@ -20,12 +28,16 @@ public:
     // Getter
     [[nodiscard]] class Actor* GetOwner() { return mOwner; }
     [[nodiscard]] int GetUpdateOrder() const { return mUpdateOrder; }
+    [[nodiscard]] bool IsInputEnabled() const { return mInputEnabled; }
+    [[nodiscard]] bool IsTickEnabled() const { return mTickEnabled; }
 
 protected:
     // Owning actor
     class Actor* mOwner;
     // Update order of component
     int mUpdateOrder;
+    bool mInputEnabled = false;
+    bool mTickEnabled = false;
 };
 
 
@@ -14,3 +14,7 @@ void CameraComponent::SetViewMatrix(const Matrix4 &view) {
     game->GetRenderer()->SetViewMatrix(view);
     game->GetAudioSystem()->SetListener(view);
 }
+
+void CameraComponent::SetDrawViewMatrix(const Matrix4 &view) {
+    mOwner->GetGame()->GetRenderer()->SetDrawViewMatrix(view);
+}
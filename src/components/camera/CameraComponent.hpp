@@ -9,4 +9,6 @@ public:
 	explicit CameraComponent(class Actor* owner, int updateOrder = 200);
 protected:
 	void SetViewMatrix(const Matrix4& view);
+	// Renderer only, for views blended between steps
+	void SetDrawViewMatrix(const Matrix4& view);
 };
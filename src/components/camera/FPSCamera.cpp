@@ -1,30 +1,46 @@
 #include "FPSCamera.hpp"
 #include "../../actors/Actor.hpp"
 
-FPSCamera::FPSCamera(Actor *owner) : CameraComponent(owner) {}
+// Look from position along forward pitched about right
+static Matrix4 CreateView(const Vector3 &position, const Vector3 &forward, const Vector3 &right, float pitch) {
+    // Make a quaternion representing pitch rotation,
+    // which is about owner's right vector
+    Quaternion q(right, pitch);
+
+    // Rotate owner forward by pitch quaternion
+    Vector3 viewForward = Vector3::Transform(forward, q);
+    // Target position 100 units in front of view forward
+    Vector3 target = position + viewForward * 100.0f;
+    // Also rotate up by pitch quaternion
+    Vector3 up = Vector3::Transform(Vector3::UnitZ, q);
+
+    // Create look at matrix
+    return Matrix4::CreateLookAt(position, target, up);
+}
+
+FPSCamera::FPSCamera(Actor *owner) : CameraComponent(owner) {
+    SetTickEnabled(true);
+}
 
 void FPSCamera::Update(float deltaTime) {
     // Call parent update (doesn't do anything right now)
     CameraComponent::Update(deltaTime);
-    // Camera position is owner position
-    Vector3 cameraPos = mOwner->GetPosition();
 
     // Update pitch based on pitch speed
+    mPrevPitch = mPitch;
     mPitch += mPitchSpeed * deltaTime;
     // Clamp pitch to [-max, +max]
     mPitch = std::clamp(mPitch, -mMaxPitch, mMaxPitch);
-    // Make a quaternion representing pitch rotation,
-    // which is about owner's right vector
-    Quaternion q(mOwner->GetRight(), mPitch);
 
-    // Rotate owner forward by pitch quaternion
-    Vector3 viewForward = Vector3::Transform(mOwner->GetForward(), q);
-    // Target position 100 units in front of view forward
-    Vector3 target = cameraPos + viewForward * 100.0f;
-    // Also rotate up by pitch quaternion
-    Vector3 up = Vector3::Transform(Vector3::UnitZ, q);
+    // Camera position is owner position, set as view
+    SetViewMatrix(CreateView(mOwner->GetPosition(), mOwner->GetForward(), mOwner->GetRight(), mPitch));
+}
 
-    // Create look at matrix, set as view
-    Matrix4 view = Matrix4::CreateLookAt(cameraPos, target, up);
-    SetViewMatrix(view);
+void FPSCamera::UpdateView(float alpha) {
+    Matrix4 transform = mOwner->GetInterpolatedTransform(alpha);
+    Vector3 forward = transform.GetXAxis();
+    Vector3 right = transform.GetYAxis();
+    forward.Normalize();
+    right.Normalize();
+    SetDrawViewMatrix(CreateView(transform.GetTranslation(), forward, right, Math::Lerp(mPrevPitch, mPitch, alpha)));
 }
@@ -7,6 +7,8 @@ public:
     explicit FPSCamera(class Actor* owner);
 
     void Update(float deltaTime) override;
+    // Draw view between the last two steps, from the owner's interpolated transform
+    void UpdateView(float alpha);
 
     // Getter
     [[nodiscard]] float GetPitch() const { return mPitch; }
@@ -24,6 +26,7 @@ private:
     float mMaxPitch = Math::Pi / 3.0f;
     // Current pitch
     float mPitch = 0;
+    float mPrevPitch = 0;  // pitch of the previous step
 };
 
 
@@ -2,7 +2,9 @@
 #include "../../actors/Actor.hpp"
 
 
-FollowCamera::FollowCamera(Actor* owner) : CameraComponent(owner) { }
+FollowCamera::FollowCamera(Actor* owner) : CameraComponent(owner) {
+    SetTickEnabled(true);
+}
 
 void FollowCamera::Update(float deltaTime) {
     CameraComponent::Update(deltaTime);
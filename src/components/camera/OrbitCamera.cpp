@@ -1,7 +1,9 @@
 #include "OrbitCamera.hpp"
 #include "../../actors/Actor.hpp"
 
-OrbitCamera::OrbitCamera(Actor *owner) : CameraComponent(owner) {}
+OrbitCamera::OrbitCamera(Actor *owner) : CameraComponent(owner) {
+    SetTickEnabled(true);
+}
 
 
 void OrbitCamera::Update(float deltaTime) {
@@ -25,7 +25,9 @@ Vector3 Spline::Compute(size_t startIdx, float t) const {
     return position;
 }
 
-SplineCamera::SplineCamera(Actor *owner) : CameraComponent(owner) {}
+SplineCamera::SplineCamera(Actor *owner) : CameraComponent(owner) {
+    SetTickEnabled(true);
+}
 
 void SplineCamera::Update(float deltaTime) {
     CameraComponent::Update(deltaTime);
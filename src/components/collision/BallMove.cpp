@@ -5,9 +5,16 @@
 #include "../../actors/BallActor.hpp"
 #include "../../actors/TargetActor.hpp"
 
-BallMove::BallMove(Actor *owner) : MoveComponent(owner) {}
+BallMove::BallMove(Actor *owner) : MoveComponent(owner) {
+    SetTickEnabled(true);
+}
+
+void BallMove::SetPlayer(Actor *player) {
+    mPlayer = player->GetHandle();
+}
 
 void BallMove::Update(float deltaTime) {
+    // Forward speed is already integrated by EntityStorage::UpdateMovement, only reflect here
     // Construct segment in direction of travel
     const float segmentLength = 30.0f;
     Vector3 start = mOwner->GetPosition();
@@ -22,7 +29,7 @@ void BallMove::Update(float deltaTime) {
     PhysWorld::CollisionInfo info{};
 
     // (Don't collide vs player)
-    if (phys->SegmentCast(l, info) && info.mActor != mPlayer) {
+    if (phys->SegmentCast(l, info) && info.mActor->GetHandle() != mPlayer) {
         // If we collided, reflect the ball about the normal
         dir = Vector3::Reflect(dir, info.mNormal);
 
@@ -31,10 +38,9 @@ void BallMove::Update(float deltaTime) {
         // Game specific -- Did we hit a target?
         auto *target = dynamic_cast<TargetActor *>(info.mActor);
         if (target) {
-            dynamic_cast<BallActor *>(mOwner)->HitTarget();
+            // Audio is not safe from worker threads, play it at the sync point
+            auto *ball = dynamic_cast<BallActor *>(mOwner);
+            mOwner->GetGame()->Defer([ball]() { ball->HitTarget(); });
         }
     }
-
-    // Base class update moves based on forward speed
-    MoveComponent::Update(deltaTime);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../control/MoveComponent.hpp"
+#include "../../actors/ActorRegistry.hpp"
 
 class BallMove : public MoveComponent {
 public:
@@ -8,8 +9,8 @@ public:
 
     void Update(float deltaTime) override;
 
-    void SetPlayer(Actor *player) { mPlayer = player; }
+    void SetPlayer(class Actor *player);
 
 protected:
-    class Actor *mPlayer = nullptr;
+    ActorHandle mPlayer;  // handle so we don't keep a dangling pointer to the player
 };
\ No newline at end of file
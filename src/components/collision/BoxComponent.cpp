@@ -1,30 +1,38 @@
 #include "BoxComponent.hpp"
 #include "../../actors/Actor.hpp"
 #include "../../Game.hpp"
-#include "../../core/PhysWorld.hpp"
 
 BoxComponent::BoxComponent(Actor *owner, int updateOrder)
-        : Component(owner, updateOrder) {
-    mOwner->GetGame()->GetPhysWorld()->AddBox(this);
+        : Component(owner, updateOrder),
+          mStorage(&owner->GetGame()->GetEntityStorage()),
+          mEntity(owner->GetHandle().mIndex) {
+    // A second one on the same actor shares the first one's row, only the first removes it
+    mOwnsRow = mStorage->AddBox(mEntity, this);
 }
 
 BoxComponent::~BoxComponent() {
-    mOwner->GetGame()->GetPhysWorld()->RemoveBox(this);
+    if (mOwnsRow) {
+        mStorage->RemoveBox(mEntity);
+    }
 }
 
 void BoxComponent::OnUpdateWorldTransform() {
+    BoxTable &boxes = Boxes();
+    uint32_t row = Row();
+
     // Reset to object space box
-    mWorldBox = mObjectBox;
+    AABB &worldBox = boxes.mWorldBoxes[row];
+    worldBox = boxes.mObjectBoxes[row];
 
     // Must apply transform in this order
     // Scale
-    mWorldBox.mMin *= mOwner->GetScale();
-    mWorldBox.mMax *= mOwner->GetScale();
+    worldBox.mMin *= mOwner->GetScale();
+    worldBox.mMax *= mOwner->GetScale();
     // Rotate (if we want to)
-    if (mShouldRotate) {
-        mWorldBox.Rotate(mOwner->GetRotation());
+    if (boxes.mShouldRotate[row]) {
+        worldBox.Rotate(mOwner->GetRotation());
     }
     // Translate
-    mWorldBox.mMin += mOwner->GetPosition();
-    mWorldBox.mMax += mOwner->GetPosition();
+    worldBox.mMin += mOwner->GetPosition();
+    worldBox.mMax += mOwner->GetPosition();
 }
@@ -2,7 +2,9 @@
 
 #include "../Component.hpp"
 #include "../../helper/Collision.hpp"
+#include "../../core/EntityStorage.hpp"
 
+// Boxes live in the entity storage box table so PhysWorld iterates them linearly (one per actor)
 class BoxComponent : public Component {
 public:
     explicit BoxComponent(class Actor *owner, int updateOrder = 100);
@@ -10,15 +12,18 @@ public:
 
     void OnUpdateWorldTransform() override;
 
-    // Getter
-    [[nodiscard]] const AABB &GetWorldBox() const { return mWorldBox; }
+    // Getter, word space, keep changing
+    [[nodiscard]] AABB GetWorldBox() const { return Boxes().mWorldBoxes[Row()]; }
 
     // Setter
-    void SetObjectBox(const AABB &model) { mObjectBox = model; }
-    void SetShouldRotate(bool value) { mShouldRotate = value; }
+    void SetObjectBox(const AABB &model) { Boxes().mObjectBoxes[Row()] = model; }  // object space
+    void SetShouldRotate(bool value) { Boxes().mShouldRotate[Row()] = value; }  // rotate based on the world rotation
 
 private:
-    AABB mObjectBox{Vector3::Zero, Vector3::Zero};  // object space
-    AABB mWorldBox{Vector3::Zero, Vector3::Zero};  // word space, keep changing
-    bool mShouldRotate = true;  // rotate based on the world rotation
+    BoxTable& Boxes() const { return mStorage->GetBoxes(); }
+    [[nodiscard]] uint32_t Row() const { return mStorage->GetBoxes().mSet.GetRow(mEntity); }
+
+    class EntityStorage *mStorage;
+    uint32_t mEntity;
+    bool mOwnsRow = false;
 };
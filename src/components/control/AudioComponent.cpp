@@ -32,6 +32,11 @@ void AudioComponent::Update(float deltaTime) {
             ++iter;
         }
     }
+
+    // Nothing left to clean up, tick again when an event is played
+    if (mEvents2D.empty() && mEvents3D.empty()) {
+        SetTickEnabled(false);
+    }
 }
 
 void AudioComponent::OnUpdateWorldTransform() {
@@ -46,6 +51,7 @@ void AudioComponent::OnUpdateWorldTransform() {
 
 SoundEvent AudioComponent::PlayEvent(const std::string &name) {
     SoundEvent e = mOwner->GetGame()->GetAudioSystem()->PlayEvent(name);
+    SetTickEnabled(true);
     // Is this 2D or 3D?
     if (e.Is3D()) {
         mEvents3D.emplace_back(e);
@@ -1,7 +1,9 @@
 #include "InputComponent.hpp"
 #include "../../core/InputSystem.hpp"
 
-InputComponent::InputComponent(class Actor *owner) : MoveComponent(owner){}
+InputComponent::InputComponent(class Actor *owner) : MoveComponent(owner) {
+    SetInputEnabled(true);
+}
 
 void InputComponent::ProcessInput(const InputState& state) {
     // Calculate forward speed for MoveComponent
@@ -1,27 +1,17 @@
 #include "MoveComponent.hpp"
 #include "../../actors/Actor.hpp"
+#include "../../Game.hpp"
 
 MoveComponent::MoveComponent(class Actor *owner, int updateOrder)
-        : Component(owner, updateOrder) {}
-
-void MoveComponent::Update(float deltaTime) {
-    // Update rotation in Quaternion
-    if (!Math::NearZero(mAngularSpeed)) {
-        Quaternion rot = mOwner->GetRotation();
-        float angle = mAngularSpeed * deltaTime;
-
-        // Rotate up axis only (temporary)
-        Quaternion inc(Vector3::UnitZ, angle);
-        // Concatenate old and new quaternion
-        rot = Quaternion::Concatenate(rot, inc);
-        mOwner->SetRotation(rot);
-    }
+        : Component(owner, updateOrder),
+          mStorage(&owner->GetGame()->GetEntityStorage()),
+          mEntity(owner->GetHandle().mIndex) {
+    // A second one on the same actor shares the first one's row, only the first removes it
+    mOwnsRow = mStorage->AddMotion(mEntity);
+}
 
-    // Update position in a similar fashion
-    if (!Math::NearZero(mForwardSpeed) || !Math::NearZero(mStrafeSpeed)) {
-        Vector3 pos = mOwner->GetPosition();
-        pos += mOwner->GetForward() * mForwardSpeed * deltaTime;
-        pos += mOwner->GetRight() * mStrafeSpeed * deltaTime;
-        mOwner->SetPosition(pos);
+MoveComponent::~MoveComponent() {
+    if (mOwnsRow) {
+        mStorage->RemoveMotion(mEntity);
     }
 }
@@ -1,28 +1,30 @@
 #pragma once
 #include "../Component.hpp"
+#include "../../core/EntityStorage.hpp"
 
+// Speeds live in the entity storage motion table, EntityStorage::UpdateMovement integrates
+// them for all actors at the start of the step (one MoveComponent per actor)
 class MoveComponent : public Component {
 public:
     // Lower update order to update first
     explicit MoveComponent(class Actor* owner, int updateOrder = 10);
+    ~MoveComponent();
 
-    void Update(float deltaTime) override;
-
-    [[nodiscard]] float GetAngularSpeed() const { return mAngularSpeed; }
-    [[nodiscard]] float GetForwardSpeed() const { return mForwardSpeed; }
-    [[nodiscard]] float GetStrafeSpeed() const { return mStrafeSpeed; }
-    void SetAngularSpeed(float speed) { mAngularSpeed = speed; }
-    void SetForwardSpeed(float speed) { mForwardSpeed = speed; }
-    void SetStrafeSpeed(float speed) { mStrafeSpeed = speed; }
-
-private:
+    [[nodiscard]] float GetAngularSpeed() const { return Motions().mAngularSpeeds[Row()]; }
+    [[nodiscard]] float GetForwardSpeed() const { return Motions().mForwardSpeeds[Row()]; }
+    [[nodiscard]] float GetStrafeSpeed() const { return Motions().mStrafeSpeeds[Row()]; }
     // Controls rotation (radians/second)
-    float mAngularSpeed = 0;
+    void SetAngularSpeed(float speed) { Motions().mAngularSpeeds[Row()] = speed; }
     // Controls forward movement (units/second)
-    float mForwardSpeed = 0;
+    void SetForwardSpeed(float speed) { Motions().mForwardSpeeds[Row()] = speed; }
     // Controls side movement (units/second)
-    float mStrafeSpeed = 0;
-};
-
+    void SetStrafeSpeed(float speed) { Motions().mStrafeSpeeds[Row()] = speed; }
 
+private:
+    MotionTable& Motions() const { return mStorage->GetMotions(); }
+    [[nodiscard]] uint32_t Row() const { return mStorage->GetMotions().mSet.GetRow(mEntity); }
 
+    class EntityStorage* mStorage;
+    uint32_t mEntity;
+    bool mOwnsRow = false;
+};
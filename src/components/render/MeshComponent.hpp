@@ -8,21 +8,26 @@ public:
     explicit MeshComponent(class Actor *owner);
     ~MeshComponent();
 
-    // Draw this mesh component with specified shader
-    virtual void Draw(class Shader *shader);
-
     // Set the mesh/texture index used by mesh component
     virtual void SetMesh(class Mesh *mesh);
 
     // Setter
     void SetTextureIndex(size_t index) { mTextureIndex = index; }
     void SetVisible(bool visible) { mVisible = visible; }
+    // Static meshes are merged with others in world space by the renderer, moving the owner
+    // afterwards doesn't move what is drawn. Set before SetMesh
+    void SetStatic(bool isStatic) { mStatic = isStatic; }
 
     // Getter
     [[nodiscard]] bool GetVisible() const { return mVisible; }
+    [[nodiscard]] bool IsStatic() const { return mStatic; }
+    [[nodiscard]] class Mesh* GetMesh() const { return mMesh; }
+    // Texture at the texture index, nullptr if the mesh has none there
+    [[nodiscard]] class Texture* GetTexture() const;
 
 protected:
     class Mesh *mMesh = nullptr;
     size_t mTextureIndex = 0;
     bool mVisible = true;
+    bool mStatic = false;
 };
@@ -1,6 +1,6 @@
 #include "../../actors/Actor.hpp"
 #include "../../Game.hpp"
-#include "../../core/Shader.hpp"
+#include "../../helper/SpriteBatch.hpp"
 #include "SpriteComponent.hpp"
 #include "../../helper/Texture.hpp"
 #include "../../core/Renderer.hpp"
@@ -14,7 +14,7 @@ SpriteComponent::~SpriteComponent() {
     mOwner->GetGame()->GetRenderer()->RemoveSprite(this);
 }
 
-void SpriteComponent::Draw(Shader *shader) {
+void SpriteComponent::Draw(SpriteBatch *batch) {
     if (mTexture) {
         // Scale the quad by the width/height of texture
         Matrix4 scaleMat = Matrix4::CreateScale(
@@ -24,16 +24,8 @@ void SpriteComponent::Draw(Shader *shader) {
 
         Matrix4 world = scaleMat * mOwner->GetWorldTransform();
 
-        // Since all sprites use the same shader/vertices,
-        // the game first sets them active before any sprite draws
-
-        // Set world transform
-        shader->SetMatrixUniform("uWorldTransform", world);
-
-        // Set current texture
-        mTexture->SetActive();
-        // Draw quad
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        // Drawn when the renderer ends the batch, with the other sprites using this texture
+        batch->Draw(mTexture, world, mDrawOrder);
     }
 }
 
@@ -7,7 +7,8 @@ public:
     explicit SpriteComponent(class Actor* owner, int updateOrder = 100);
     ~SpriteComponent() override;
 
-    virtual void Draw(class Shader *renderer);
+    // Add this sprite to the frame's sprite batch
+    virtual void Draw(class SpriteBatch *batch);
     virtual void SetTexture(class Texture *texture);
 
     // Getter
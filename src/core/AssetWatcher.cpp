@@ -0,0 +1,124 @@
+#include "AssetWatcher.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <SDL.h>
+#include "../Game.hpp"
+#include "../helper/Profiler.hpp"
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+AssetWatcher::~AssetWatcher() {
+    Stop();
+}
+
+bool AssetWatcher::Start(const std::vector<std::string> &directories) {
+#ifdef __linux__
+    mInotify = inotify_init1(IN_NONBLOCK);
+    if (mInotify < 0) {
+        SDL_Log("Failed to initialize inotify: %s", strerror(errno));
+        return false;
+    }
+    // Editors either write in place or write a temp file and rename it over
+    for (const auto &directory: directories) {
+        int watch = inotify_add_watch(mInotify, (Game::PROJECT_BASE + directory).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch < 0) {
+            SDL_Log("Failed to watch %s: %s", directory.c_str(), strerror(errno));
+            continue;
+        }
+        mWatches[watch] = directory;
+    }
+#else
+    mDirectories = directories;
+    Scan(false);
+#endif
+
+    mRunning = true;
+    mThread = std::thread(&AssetWatcher::WatchLoop, this);
+    SDL_Log("Watching %zu directories for asset changes", directories.size());
+    return true;
+}
+
+void AssetWatcher::Stop() {
+    if (!mRunning) {
+        return;
+    }
+    mRunning = false;
+    mThread.join();
+#ifdef __linux__
+    close(mInotify);
+    mInotify = -1;
+    mWatches.clear();
+#endif
+}
+
+std::vector<std::string> AssetWatcher::TakeChanges() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::string> changes;
+    changes.swap(mChanges);
+    return changes;
+}
+
+void AssetWatcher::PushChange(const std::string &fileName) {
+    // Several writes of one save come as several events, report the file once
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (std::find(mChanges.begin(), mChanges.end(), fileName) == mChanges.end()) {
+        mChanges.emplace_back(fileName);
+    }
+}
+
+#ifdef __linux__
+void AssetWatcher::WatchLoop() {
+    Profiler::SetThreadName("Asset watcher");
+    alignas(inotify_event) char buffer[4096];
+    while (mRunning) {
+        // Timeout so Stop doesn't wait for the next event
+        pollfd fd{mInotify, POLLIN, 0};
+        if (poll(&fd, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+
+        ssize_t length = read(mInotify, buffer, sizeof(buffer));
+        for (ssize_t i = 0; i < length;) {
+            auto *event = reinterpret_cast<inotify_event *>(buffer + i);
+            if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                PushChange(mWatches[event->wd] + "/" + event->name);
+            }
+            i += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+}
+#else
+void AssetWatcher::WatchLoop() {
+    Profiler::SetThreadName("Asset watcher");
+    while (mRunning) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        Scan(true);
+    }
+}
+
+void AssetWatcher::Scan(bool report) {
+    for (const auto &directory: mDirectories) {
+        std::error_code error;
+        for (const auto &entry: std::filesystem::directory_iterator(Game::PROJECT_BASE + directory, error)) {
+            if (!entry.is_regular_file(error)) {
+                continue;
+            }
+            std::string fileName = directory + "/" + entry.path().filename().string();
+            auto writeTime = entry.last_write_time(error);
+            auto iter = mWriteTimes.find(fileName);
+            if (iter == mWriteTimes.end()) {
+                mWriteTimes.emplace(fileName, writeTime);
+            } else if (iter->second != writeTime) {
+                iter->second = writeTime;
+                if (report) {
+                    PushChange(fileName);
+                }
+            }
+        }
+    }
+}
+#endif
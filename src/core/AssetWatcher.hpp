@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#ifndef __linux__
+#include <filesystem>
+#endif
+
+// Report files written under asset directories, for hot reload. A background thread waits on
+// inotify on Linux and polls modification times on other platforms
+class AssetWatcher {
+public:
+    AssetWatcher() = default;
+    ~AssetWatcher();
+
+    AssetWatcher(const AssetWatcher &) = delete;
+    AssetWatcher &operator=(const AssetWatcher &) = delete;
+
+    // Directories relative to the project base, like "Assets"
+    bool Start(const std::vector<std::string> &directories);
+    void Stop();
+
+    // Files changed since last call, relative to the project base like "Assets/Cube.gpmesh"
+    std::vector<std::string> TakeChanges();
+
+private:
+    void WatchLoop();
+    void PushChange(const std::string &fileName);
+
+    std::thread mThread;
+    std::atomic<bool> mRunning{false};
+    std::mutex mMutex;
+    std::vector<std::string> mChanges;  // guarded by mMutex
+
+#ifdef __linux__
+    int mInotify = -1;
+    std::unordered_map<int, std::string> mWatches;  // watch descriptor -> directory
+#else
+    void Scan(bool report);
+    std::vector<std::string> mDirectories;
+    std::unordered_map<std::string, std::filesystem::file_time_type> mWriteTimes;
+#endif
+
+    constexpr static int POLL_INTERVAL_MS = 250;
+};
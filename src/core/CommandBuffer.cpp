@@ -0,0 +1,41 @@
+#include "CommandBuffer.hpp"
+#include <algorithm>
+#include "JobSystem.hpp"
+
+namespace {
+    thread_local uint32_t tOrder = 0;
+}
+
+void CommandBuffer::Begin(unsigned int threadCount) {
+    mQueues.resize(std::max(threadCount, 1u));
+    mRecording = true;
+}
+
+void CommandBuffer::SetOrder(uint32_t order) {
+    tOrder = order;
+}
+
+void CommandBuffer::Record(Command command) {
+    auto &queue = mQueues[JobSystem::GetThreadIndex()];
+    queue.push_back({tOrder, static_cast<uint32_t>(queue.size()), std::move(command)});
+}
+
+void CommandBuffer::Playback() {
+    mRecording = false;
+
+    // Merge, commands of one order key were recorded by one thread so the sequence is comparable
+    for (auto &queue: mQueues) {
+        for (auto &entry: queue) {
+            mMerged.emplace_back(std::move(entry));
+        }
+        queue.clear();
+    }
+    std::sort(mMerged.begin(), mMerged.end(), [](const Entry &a, const Entry &b) {
+        return a.mOrder != b.mOrder ? a.mOrder < b.mOrder : a.mSequence < b.mSequence;
+    });
+
+    for (auto &entry: mMerged) {
+        entry.mCommand();
+    }
+    mMerged.clear();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Structural changes (spawn, state change, audio...) recorded by many threads during a parallel
+// update and played back on the main thread at the sync point.
+// Every thread records into its own queue, playback sorts by the order key so the result
+// doesn't depend on which thread ran which actor.
+class CommandBuffer {
+public:
+    using Command = std::function<void()>;
+
+    // Start recording with one queue per job system thread
+    void Begin(unsigned int threadCount);
+    // Sort key of following records on the calling thread, usually index of the actor being updated
+    static void SetOrder(uint32_t order);
+    void Record(Command command);
+    // Stop recording and run all commands on the calling thread
+    void Playback();
+
+    [[nodiscard]] bool IsRecording() const { return mRecording; }
+
+private:
+    struct Entry {
+        uint32_t mOrder;
+        uint32_t mSequence;  // record order within the thread, keeps sort stable
+        Command mCommand;
+    };
+
+    std::vector<std::vector<Entry>> mQueues;  // per thread
+    std::vector<Entry> mMerged;
+    bool mRecording = false;
+};
@@ -0,0 +1,312 @@
+#include "EntityStorage.hpp"
+#include <algorithm>
+#include <SDL.h>
+#include "../helper/Profiler.hpp"
+#include "../actors/Actor.hpp"
+
+namespace {
+    // Mirror SparseSet::Remove on a column
+    template<typename T>
+    void SwapPop(std::vector<T> &column, uint32_t row) {
+        column[row] = column.back();
+        column.pop_back();
+    }
+}
+
+uint32_t SparseSet::Insert(uint32_t entity) {
+    // Overwriting the slot would orphan the old dense row
+    if (Contains(entity)) {
+        SDL_Log("Entity %u already has a row in this table", entity);
+        return INVALID_ROW;
+    }
+    if (entity >= mSparse.size()) {
+        mSparse.resize(entity + 1, INVALID_ROW);
+    }
+    auto row = static_cast<uint32_t>(mDense.size());
+    mSparse[entity] = row;
+    mDense.emplace_back(entity);
+    return row;
+}
+
+uint32_t SparseSet::Remove(uint32_t entity) {
+    uint32_t row = mSparse[entity];
+    uint32_t last = mDense.back();
+
+    // Move last entity into the hole
+    mDense[row] = last;
+    mSparse[last] = row;
+    mDense.pop_back();
+    mSparse[entity] = INVALID_ROW;
+    return row;
+}
+
+bool EntityStorage::AddTransform(uint32_t entity, Actor *actor) {
+    if (mTransforms.mSet.Insert(entity) == SparseSet::INVALID_ROW) {
+        return false;
+    }
+    mTransforms.mPositions.emplace_back(Vector3::Zero);
+    mTransforms.mRotations.emplace_back(Quaternion::Identity);
+    mTransforms.mScales.emplace_back(1.0f);
+    mTransforms.mWorldTransforms.emplace_back(Matrix4::Identity);
+    mTransforms.mPrevPositions.emplace_back(Vector3::Zero);
+    mTransforms.mPrevRotations.emplace_back(Quaternion::Identity);
+    mTransforms.mPrevScales.emplace_back(1.0f);
+    mTransforms.mDirty.emplace_back(1);
+    mTransforms.mMoved.emplace_back(0);
+    mTransforms.mHasPrev.emplace_back(0);
+    mTransforms.mActive.emplace_back(1);
+    mTransforms.mParents.emplace_back(TransformTable::NO_ENTITY);
+    mTransforms.mFirstChildren.emplace_back(TransformTable::NO_ENTITY);
+    mTransforms.mNextSiblings.emplace_back(TransformTable::NO_ENTITY);
+    mTransforms.mActors.emplace_back(actor);
+
+    // A root can go anywhere in the depth order
+    mDepthOrder.emplace_back(entity);
+    return true;
+}
+
+void EntityStorage::RemoveTransform(uint32_t entity) {
+    TransformTable &t = mTransforms;
+
+    // Children become roots, keeping their local transform
+    uint32_t child = t.mFirstChildren[t.mSet.GetRow(entity)];
+    while (child != TransformTable::NO_ENTITY) {
+        uint32_t childRow = t.mSet.GetRow(child);
+        uint32_t next = t.mNextSiblings[childRow];
+        t.mParents[childRow] = TransformTable::NO_ENTITY;
+        t.mNextSiblings[childRow] = TransformTable::NO_ENTITY;
+        t.mDirty[childRow] = 1;
+        child = next;
+    }
+    Unlink(entity);
+    mDepthOrderDirty = true;
+
+    uint32_t row = mTransforms.mSet.Remove(entity);
+    SwapPop(mTransforms.mPositions, row);
+    SwapPop(mTransforms.mRotations, row);
+    SwapPop(mTransforms.mScales, row);
+    SwapPop(mTransforms.mWorldTransforms, row);
+    SwapPop(mTransforms.mPrevPositions, row);
+    SwapPop(mTransforms.mPrevRotations, row);
+    SwapPop(mTransforms.mPrevScales, row);
+    SwapPop(mTransforms.mDirty, row);
+    SwapPop(mTransforms.mMoved, row);
+    SwapPop(mTransforms.mHasPrev, row);
+    SwapPop(mTransforms.mActive, row);
+    SwapPop(mTransforms.mParents, row);
+    SwapPop(mTransforms.mFirstChildren, row);
+    SwapPop(mTransforms.mNextSiblings, row);
+    SwapPop(mTransforms.mActors, row);
+}
+
+void EntityStorage::ReserveTransforms(size_t count) {
+    TransformTable &t = mTransforms;
+    size_t total = t.mSet.Size() + count;
+    t.mPositions.reserve(total);
+    t.mRotations.reserve(total);
+    t.mScales.reserve(total);
+    t.mWorldTransforms.reserve(total);
+    t.mPrevPositions.reserve(total);
+    t.mPrevRotations.reserve(total);
+    t.mPrevScales.reserve(total);
+    t.mDirty.reserve(total);
+    t.mMoved.reserve(total);
+    t.mHasPrev.reserve(total);
+    t.mActive.reserve(total);
+    t.mParents.reserve(total);
+    t.mFirstChildren.reserve(total);
+    t.mNextSiblings.reserve(total);
+    t.mActors.reserve(total);
+    mDepthOrder.reserve(total);
+}
+
+bool EntityStorage::SetParent(uint32_t entity, uint32_t parent) {
+    TransformTable &t = mTransforms;
+    uint32_t row = t.mSet.GetRow(entity);
+    if (t.mParents[row] == parent) {
+        return true;
+    }
+
+    // Parent can't be ourselves or one of our descendants
+    for (uint32_t p = parent; p != TransformTable::NO_ENTITY; p = t.mParents[t.mSet.GetRow(p)]) {
+        if (p == entity) {
+            SDL_Log("Can't parent entity %u to its own descendant %u", entity, parent);
+            return false;
+        }
+    }
+
+    Unlink(entity);
+    if (parent != TransformTable::NO_ENTITY) {
+        uint32_t parentRow = t.mSet.GetRow(parent);
+        t.mParents[row] = parent;
+        t.mNextSiblings[row] = t.mFirstChildren[parentRow];
+        t.mFirstChildren[parentRow] = entity;
+    }
+    t.mDirty[row] = 1;
+    mDepthOrderDirty = true;
+    return true;
+}
+
+void EntityStorage::Unlink(uint32_t entity) {
+    TransformTable &t = mTransforms;
+    uint32_t row = t.mSet.GetRow(entity);
+    uint32_t parent = t.mParents[row];
+    if (parent == TransformTable::NO_ENTITY) {
+        return;
+    }
+
+    // Find the link pointing at us in parent's child list
+    uint32_t *link = &t.mFirstChildren[t.mSet.GetRow(parent)];
+    while (*link != entity) {
+        link = &t.mNextSiblings[t.mSet.GetRow(*link)];
+    }
+    *link = t.mNextSiblings[row];
+    t.mParents[row] = TransformTable::NO_ENTITY;
+    t.mNextSiblings[row] = TransformTable::NO_ENTITY;
+}
+
+bool EntityStorage::AddMotion(uint32_t entity) {
+    if (mMotions.mSet.Insert(entity) == SparseSet::INVALID_ROW) {
+        return false;
+    }
+    mMotions.mAngularSpeeds.emplace_back(0.0f);
+    mMotions.mForwardSpeeds.emplace_back(0.0f);
+    mMotions.mStrafeSpeeds.emplace_back(0.0f);
+    return true;
+}
+
+void EntityStorage::RemoveMotion(uint32_t entity) {
+    uint32_t row = mMotions.mSet.Remove(entity);
+    SwapPop(mMotions.mAngularSpeeds, row);
+    SwapPop(mMotions.mForwardSpeeds, row);
+    SwapPop(mMotions.mStrafeSpeeds, row);
+}
+
+bool EntityStorage::AddBox(uint32_t entity, BoxComponent *box) {
+    if (mBoxes.mSet.Insert(entity) == SparseSet::INVALID_ROW) {
+        return false;
+    }
+    mBoxes.mObjectBoxes.emplace_back(Vector3::Zero, Vector3::Zero);
+    mBoxes.mWorldBoxes.emplace_back(Vector3::Zero, Vector3::Zero);
+    mBoxes.mShouldRotate.emplace_back(1);
+    mBoxes.mComponents.emplace_back(box);
+    return true;
+}
+
+void EntityStorage::RemoveBox(uint32_t entity) {
+    uint32_t row = mBoxes.mSet.Remove(entity);
+    SwapPop(mBoxes.mObjectBoxes, row);
+    SwapPop(mBoxes.mWorldBoxes, row);
+    SwapPop(mBoxes.mShouldRotate, row);
+    SwapPop(mBoxes.mComponents, row);
+}
+
+void EntityStorage::BeginStep() {
+    PROFILE_SCOPE("EntityStorage::BeginStep");
+    // Plain copies of whole columns
+    mTransforms.mPrevPositions = mTransforms.mPositions;
+    mTransforms.mPrevRotations = mTransforms.mRotations;
+    mTransforms.mPrevScales = mTransforms.mScales;
+    std::fill(mTransforms.mHasPrev.begin(), mTransforms.mHasPrev.end(), 1);
+    std::fill(mTransforms.mMoved.begin(), mTransforms.mMoved.end(), 0);
+}
+
+void EntityStorage::UpdateMovement(float deltaTime) {
+    PROFILE_SCOPE("EntityStorage::UpdateMovement");
+    TransformTable &t = mTransforms;
+    for (uint32_t i = 0; i < mMotions.mSet.Size(); i++) {
+        uint32_t row = t.mSet.GetRow(mMotions.mSet.GetEntity(i));
+        if (!t.mActive[row]) {
+            continue;
+        }
+
+        // Update rotation in Quaternion, rotate up axis only (temporary)
+        float angularSpeed = mMotions.mAngularSpeeds[i];
+        if (!Math::NearZero(angularSpeed)) {
+            Quaternion inc(Vector3::UnitZ, angularSpeed * deltaTime);
+            t.mRotations[row] = Quaternion::Concatenate(t.mRotations[row], inc);
+            t.mDirty[row] = 1;
+        }
+
+        // Update position in a similar fashion
+        float forwardSpeed = mMotions.mForwardSpeeds[i];
+        float strafeSpeed = mMotions.mStrafeSpeeds[i];
+        if (!Math::NearZero(forwardSpeed) || !Math::NearZero(strafeSpeed)) {
+            const Quaternion &rot = t.mRotations[row];
+            t.mPositions[row] += Vector3::Transform(Vector3::UnitX, rot) * forwardSpeed * deltaTime;
+            t.mPositions[row] += Vector3::Transform(Vector3::UnitY, rot) * strafeSpeed * deltaTime;
+            t.mDirty[row] = 1;
+        }
+    }
+}
+
+void EntityStorage::BeginParallelRead() {
+    mBoxes.mReadWorldBoxes = mBoxes.mWorldBoxes;
+    mParallelRead = true;
+}
+
+void EntityStorage::UpdateWorldTransforms() {
+    PROFILE_SCOPE("EntityStorage::UpdateWorldTransforms");
+    if (mDepthOrderDirty) {
+        RebuildDepthOrder();
+    }
+
+    for (auto entity: mDepthOrder) {
+        uint32_t row = mTransforms.mSet.GetRow(entity);
+        if (mTransforms.mDirty[row]) {
+            RecomputeWorldTransform(row);
+        }
+    }
+}
+
+void EntityStorage::UpdateWorldTransform(uint32_t entity) {
+    uint32_t row = mTransforms.mSet.GetRow(entity);
+    uint32_t parent = mTransforms.mParents[row];
+    if (parent != TransformTable::NO_ENTITY) {
+        UpdateWorldTransform(parent);
+    }
+    if (mTransforms.mDirty[row]) {
+        RecomputeWorldTransform(row);
+    }
+}
+
+void EntityStorage::RecomputeWorldTransform(uint32_t row) {
+    TransformTable &t = mTransforms;
+    t.mDirty[row] = 0;
+
+    // Local then parent's world
+    Matrix4 &world = t.mWorldTransforms[row];
+    world = Matrix4::CreateTransform(t.mScales[row], t.mRotations[row], t.mPositions[row]);
+    if (t.mParents[row] != TransformTable::NO_ENTITY) {
+        world *= t.mWorldTransforms[t.mSet.GetRow(t.mParents[row])];
+    }
+    t.mMoved[row] = 1;
+
+    // Children are further in the depth order, they get recomputed in the same pass
+    for (uint32_t child = t.mFirstChildren[row]; child != TransformTable::NO_ENTITY;) {
+        uint32_t childRow = t.mSet.GetRow(child);
+        t.mDirty[childRow] = 1;
+        child = t.mNextSiblings[childRow];
+    }
+
+    t.mActors[row]->OnUpdateWorldTransform();
+}
+
+void EntityStorage::RebuildDepthOrder() {
+    // Breadth first from every root
+    TransformTable &t = mTransforms;
+    mDepthOrder.clear();
+    for (uint32_t row = 0; row < t.mSet.Size(); row++) {
+        if (t.mParents[row] == TransformTable::NO_ENTITY) {
+            mDepthOrder.emplace_back(t.mSet.GetEntity(row));
+        }
+    }
+    for (size_t i = 0; i < mDepthOrder.size(); i++) {
+        uint32_t child = t.mFirstChildren[t.mSet.GetRow(mDepthOrder[i])];
+        while (child != TransformTable::NO_ENTITY) {
+            mDepthOrder.emplace_back(child);
+            child = t.mNextSiblings[t.mSet.GetRow(child)];
+        }
+    }
+    mDepthOrderDirty = false;
+}
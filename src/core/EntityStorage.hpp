@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "../helper/Math.hpp"
+#include "../helper/Collision.hpp"
+
+// Map sparse entity id (actor registry slot index) to a dense row, rows stay packed on remove
+class SparseSet {
+public:
+    constexpr static uint32_t INVALID_ROW = UINT32_MAX;
+
+    // Return the new row, always the last one. INVALID_ROW if entity already has one, which is left alone
+    uint32_t Insert(uint32_t entity);
+    // Last row is moved into the removed row, caller does the same swap on its arrays. Return removed row
+    uint32_t Remove(uint32_t entity);
+
+    // Getter
+    [[nodiscard]] bool Contains(uint32_t entity) const {
+        return entity < mSparse.size() && mSparse[entity] != INVALID_ROW;
+    }
+    [[nodiscard]] uint32_t GetRow(uint32_t entity) const { return mSparse[entity]; }
+    [[nodiscard]] uint32_t GetEntity(uint32_t row) const { return mDense[row]; }
+    [[nodiscard]] size_t Size() const { return mDense.size(); }
+
+private:
+    std::vector<uint32_t> mSparse;  // entity -> row
+    std::vector<uint32_t> mDense;  // row -> entity
+};
+
+// Structure of arrays tables, one row per entity, index every array with the same row
+
+struct TransformTable {
+    constexpr static uint32_t NO_ENTITY = UINT32_MAX;
+
+    SparseSet mSet;
+    // Local transform, relative to the parent (world for roots)
+    std::vector<Vector3> mPositions;
+    std::vector<Quaternion> mRotations;
+    std::vector<float> mScales;
+    std::vector<Matrix4> mWorldTransforms;
+    // Transform at the start of current simulation step, used for render interpolation
+    std::vector<Vector3> mPrevPositions;
+    std::vector<Quaternion> mPrevRotations;
+    std::vector<float> mPrevScales;
+    // Flags, uint8_t instead of vector<bool> so rows are plain bytes
+    std::vector<uint8_t> mDirty;  // world transform need recompute
+    std::vector<uint8_t> mMoved;  // world transform recomputed this step
+    std::vector<uint8_t> mHasPrev;  // previous step saved, 0 right after spawn
+    std::vector<uint8_t> mActive;  // owner actor is in EActive state
+    // Hierarchy by entity id (stable while rows move), children form a linked list
+    std::vector<uint32_t> mParents;
+    std::vector<uint32_t> mFirstChildren;
+    std::vector<uint32_t> mNextSiblings;
+    std::vector<class Actor*> mActors;  // owner, told when its world transform changed
+};
+
+struct MotionTable {
+    SparseSet mSet;
+    std::vector<float> mAngularSpeeds;  // radians/second around up axis
+    std::vector<float> mForwardSpeeds;  // units/second
+    std::vector<float> mStrafeSpeeds;  // units/second
+};
+
+struct BoxTable {
+    SparseSet mSet;
+    std::vector<AABB> mObjectBoxes;  // object space
+    std::vector<AABB> mWorldBoxes;  // world space, keep changing
+    std::vector<uint8_t> mShouldRotate;
+    std::vector<class BoxComponent*> mComponents;  // for collision results
+    std::vector<AABB> mReadWorldBoxes;  // copy of world boxes taken before the parallel update
+};
+
+// Data oriented storage for hot actor/component data. Actor, MoveComponent and BoxComponent
+// keep their interface but read and write their row here, systems below iterate the arrays linearly.
+// One row of each table per actor.
+class EntityStorage {
+public:
+    // Row management, called from actor/component constructor and destructor.
+    // Add returns false when the entity already has a row in that table, nothing is added then
+    bool AddTransform(uint32_t entity, class Actor* actor);
+    void RemoveTransform(uint32_t entity);
+    // Room for count more transform rows, before creating a batch of actors
+    void ReserveTransforms(size_t count);
+    bool AddMotion(uint32_t entity);
+    void RemoveMotion(uint32_t entity);
+    bool AddBox(uint32_t entity, class BoxComponent* box);
+    void RemoveBox(uint32_t entity);
+
+    // Attach to parent, NO_ENTITY to detach. Return false if it would make a cycle
+    bool SetParent(uint32_t entity, uint32_t parent);
+
+    // Systems, run in this order at the start of every simulation step
+    // Save transform for interpolation and clear per step flags
+    void BeginStep();
+    // Integrate motion rows of active actors into their transform
+    void UpdateMovement(float deltaTime);
+
+    // Recompute dirty world transforms, parents first in one pass over the depth order.
+    // A recomputed parent dirties its children, so unchanged subtrees are skipped. Run at end of step
+    void UpdateWorldTransforms();
+    // Recompute one entity (and its dirty ancestors) right away
+    void UpdateWorldTransform(uint32_t entity);
+
+    // Around the parallel actor update: actors write their own rows while queries
+    // about other actors read the buffered copy
+    void BeginParallelRead();
+    void EndParallelRead() { mParallelRead = false; }
+    // Boxes collision queries should test, live boxes outside parallel update
+    [[nodiscard]] const std::vector<AABB>& GetReadWorldBoxes() const {
+        return mParallelRead ? mBoxes.mReadWorldBoxes : mBoxes.mWorldBoxes;
+    }
+
+    // Getter
+    TransformTable& GetTransforms() { return mTransforms; }
+    MotionTable& GetMotions() { return mMotions; }
+    BoxTable& GetBoxes() { return mBoxes; }
+    [[nodiscard]] const TransformTable& GetTransforms() const { return mTransforms; }
+    [[nodiscard]] const MotionTable& GetMotions() const { return mMotions; }
+    [[nodiscard]] const BoxTable& GetBoxes() const { return mBoxes; }
+
+private:
+    TransformTable mTransforms;
+    MotionTable mMotions;
+    BoxTable mBoxes;
+    bool mParallelRead = false;
+
+    void RecomputeWorldTransform(uint32_t row);
+    void Unlink(uint32_t entity);  // remove from parent's children
+    void RebuildDepthOrder();
+
+    std::vector<uint32_t> mDepthOrder;  // entities, every parent before its children
+    bool mDepthOrderDirty = false;
+};
@@ -0,0 +1,191 @@
+#include "InputRecorder.hpp"
+#include <cstring>
+
+namespace {
+    template<typename T>
+    void WriteRaw(std::ofstream &out, const T &value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadRaw(std::ifstream &in, T &value) {
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return in.good();
+    }
+}
+
+InputRecorder::~InputRecorder() {
+    Stop();
+}
+
+bool InputRecorder::StartRecording(const std::string &fileName, unsigned int seed) {
+    Stop();
+    mOut.open(fileName, std::ios::binary);
+    if (!mOut.is_open()) {
+        SDL_Log("Failed to open input record file %s", fileName.c_str());
+        return false;
+    }
+
+    WriteRaw(mOut, MAGIC);
+    WriteRaw(mOut, VERSION);
+    WriteRaw(mOut, static_cast<Uint32>(seed));
+
+    // Force first step to write every device
+    memset(mKeyBits, 0xff, KEY_BYTES);
+    memset(&mMouse, 0xff, sizeof(MouseBlock));
+    memset(&mController, 0xff, sizeof(ControllerBlock));
+
+    mMode = ERecord;
+    mFileName = fileName;
+    mFrameCount = 0;
+    SDL_Log("Recording input to %s (seed %u)", fileName.c_str(), seed);
+    return true;
+}
+
+bool InputRecorder::StartReplay(const std::string &fileName, unsigned int &outSeed) {
+    Stop();
+    mIn.open(fileName, std::ios::binary);
+    if (!mIn.is_open()) {
+        SDL_Log("Failed to open input replay file %s", fileName.c_str());
+        return false;
+    }
+
+    Uint32 magic = 0, version = 0, seed = 0;
+    if (!ReadRaw(mIn, magic) || !ReadRaw(mIn, version) || !ReadRaw(mIn, seed) ||
+        magic != MAGIC || version != VERSION) {
+        SDL_Log("Input replay file %s is not a valid version %u log", fileName.c_str(), VERSION);
+        mIn.close();
+        return false;
+    }
+
+    memset(mKeyBits, 0, KEY_BYTES);
+    memset(&mMouse, 0, sizeof(MouseBlock));
+    memset(&mController, 0, sizeof(ControllerBlock));
+
+    outSeed = seed;
+    mMode = EReplay;
+    mFileName = fileName;
+    mFrameCount = 0;
+    SDL_Log("Replaying input from %s (seed %u)", fileName.c_str(), seed);
+    return true;
+}
+
+void InputRecorder::Stop() {
+    if (mMode == ERecord) {
+        SDL_Log("Recorded %zu input steps to %s", mFrameCount, mFileName.c_str());
+    }
+    if (mOut.is_open()) mOut.close();
+    if (mIn.is_open()) mIn.close();
+    mMode = EOff;
+}
+
+void InputRecorder::RecordFrame(const InputState &state, float deltaTime) {
+    if (mMode != ERecord) {
+        return;
+    }
+
+    // Pack keyboard into bits
+    Uint8 keyBits[KEY_BYTES]{};
+    for (int i = 0; i < SDL_NUM_SCANCODES; i++) {
+        if (state.Keyboard.mCurrState[i]) {
+            keyBits[i / 8] |= static_cast<Uint8>(1 << (i % 8));
+        }
+    }
+
+    // Zero padding too, blocks are compared and written as raw bytes
+    MouseBlock mouse;
+    memset(&mouse, 0, sizeof(MouseBlock));
+    mouse.mButtons = state.Mouse.mCurrButtons;
+    mouse.mPos[0] = state.Mouse.mMousePos.x;
+    mouse.mPos[1] = state.Mouse.mMousePos.y;
+    mouse.mScroll[0] = state.Mouse.mScrollWheel.x;
+    mouse.mScroll[1] = state.Mouse.mScrollWheel.y;
+    mouse.mIsRelative = state.Mouse.mIsRelative;
+
+    ControllerBlock controller;
+    memset(&controller, 0, sizeof(ControllerBlock));
+    for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; i++) {
+        if (state.Controller.mCurrButtons[i]) {
+            controller.mButtons |= 1u << i;
+        }
+    }
+    controller.mAxes[0] = state.Controller.mLeftTrigger;
+    controller.mAxes[1] = state.Controller.mRightTrigger;
+    controller.mAxes[2] = state.Controller.mLeftStick.x;
+    controller.mAxes[3] = state.Controller.mLeftStick.y;
+    controller.mAxes[4] = state.Controller.mRightStick.x;
+    controller.mAxes[5] = state.Controller.mRightStick.y;
+    controller.mIsConnected = state.Controller.mIsConnected;
+
+    // Only write what changed since last step
+    Uint8 flags = 0;
+    if (memcmp(keyBits, mKeyBits, KEY_BYTES) != 0) flags |= EKeyboardChanged;
+    if (memcmp(&mouse, &mMouse, sizeof(MouseBlock)) != 0) flags |= EMouseChanged;
+    if (memcmp(&controller, &mController, sizeof(ControllerBlock)) != 0) flags |= EControllerChanged;
+
+    WriteRaw(mOut, deltaTime);
+    WriteRaw(mOut, flags);
+    if (flags & EKeyboardChanged) {
+        mOut.write(reinterpret_cast<const char *>(keyBits), KEY_BYTES);
+        memcpy(mKeyBits, keyBits, KEY_BYTES);
+    }
+    if (flags & EMouseChanged) {
+        WriteRaw(mOut, mouse);
+        mMouse = mouse;
+    }
+    if (flags & EControllerChanged) {
+        WriteRaw(mOut, controller);
+        mController = controller;
+    }
+    mFrameCount++;
+}
+
+bool InputRecorder::ReplayFrame(InputSystem *input) {
+    if (mMode != EReplay) {
+        return false;
+    }
+
+    Uint8 flags = 0;
+    if (!ReadRaw(mIn, mFrameDeltaTime) || !ReadRaw(mIn, flags)) {
+        SDL_Log("Input replay finished after %zu steps", mFrameCount);
+        Stop();
+        return false;
+    }
+
+    bool ok = true;
+    if (flags & EKeyboardChanged) {
+        mIn.read(reinterpret_cast<char *>(mKeyBits), KEY_BYTES);
+        ok = ok && mIn.good();
+    }
+    if (flags & EMouseChanged) ok = ok && ReadRaw(mIn, mMouse);
+    if (flags & EControllerChanged) ok = ok && ReadRaw(mIn, mController);
+    if (!ok) {
+        SDL_Log("Input replay %s is truncated at step %zu", mFileName.c_str(), mFrameCount);
+        Stop();
+        return false;
+    }
+
+    // Unpack into input state
+    InputState &state = input->mState;
+    for (int i = 0; i < SDL_NUM_SCANCODES; i++) {
+        mKeys[i] = (mKeyBits[i / 8] >> (i % 8)) & 1;
+    }
+    state.Keyboard.mCurrState = mKeys;
+
+    state.Mouse.mCurrButtons = mMouse.mButtons;
+    state.Mouse.mMousePos = Vector2(mMouse.mPos[0], mMouse.mPos[1]);
+    state.Mouse.mScrollWheel = Vector2(mMouse.mScroll[0], mMouse.mScroll[1]);
+    state.Mouse.mIsRelative = mMouse.mIsRelative != 0;
+
+    for (int i = 0; i < SDL_CONTROLLER_BUTTON_MAX; i++) {
+        state.Controller.mCurrButtons[i] = (mController.mButtons >> i) & 1;
+    }
+    state.Controller.mLeftTrigger = mController.mAxes[0];
+    state.Controller.mRightTrigger = mController.mAxes[1];
+    state.Controller.mLeftStick = Vector2(mController.mAxes[2], mController.mAxes[3]);
+    state.Controller.mRightStick = Vector2(mController.mAxes[4], mController.mAxes[5]);
+    state.Controller.mIsConnected = mController.mIsConnected != 0;
+
+    mFrameCount++;
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <SDL.h>
+#include <fstream>
+#include <string>
+#include "InputSystem.hpp"
+
+// Record per simulation step input state + delta time into a binary log, and feed it back later.
+// File layout: header (magic, version, RNG seed), then per step a delta time, a flag byte telling which
+// devices changed since last step, and the changed device blocks only (idle steps cost 5 bytes)
+class InputRecorder {
+public:
+    enum Mode {
+        EOff,
+        ERecord,
+        EReplay
+    };
+
+    ~InputRecorder();
+
+    // Record using given RNG seed
+    bool StartRecording(const std::string &fileName, unsigned int seed);
+    // Replay from file, outSeed is the RNG seed used during recording
+    bool StartReplay(const std::string &fileName, unsigned int &outSeed);
+    void Stop();
+
+    // Write the input state of this simulation step
+    void RecordFrame(const InputState &state, float deltaTime);
+    // Overwrite input system state with next recorded step, return false when log ends
+    bool ReplayFrame(class InputSystem *input);
+
+    // Getter
+    [[nodiscard]] Mode GetMode() const { return mMode; }
+    [[nodiscard]] bool IsReplaying() const { return mMode == EReplay; }
+    [[nodiscard]] bool IsRecording() const { return mMode == ERecord; }
+    [[nodiscard]] float GetFrameDeltaTime() const { return mFrameDeltaTime; }  // delta of last replayed step
+
+private:
+    // Device blocks compared against previous step (plain data, memset before use)
+    struct MouseBlock {
+        Uint32 mButtons;
+        float mPos[2];
+        float mScroll[2];
+        Uint8 mIsRelative;
+    };
+    struct ControllerBlock {
+        Uint32 mButtons;
+        float mAxes[6];  // left trigger, right trigger, left stick, right stick
+        Uint8 mIsConnected;
+    };
+
+    enum ChangedFlag : Uint8 {
+        EKeyboardChanged = 1 << 0,
+        EMouseChanged = 1 << 1,
+        EControllerChanged = 1 << 2
+    };
+
+    constexpr static Uint32 MAGIC = 0x43455245;  // "EREC"
+    constexpr static Uint32 VERSION = 1;
+    constexpr static size_t KEY_BYTES = SDL_NUM_SCANCODES / 8;  // keyboard packed as bits
+
+    Mode mMode = EOff;
+    std::ofstream mOut;
+    std::ifstream mIn;
+    std::string mFileName;
+    size_t mFrameCount = 0;
+    float mFrameDeltaTime = 0;
+
+    // Last written/read step
+    Uint8 mKeyBits[KEY_BYTES]{};
+    MouseBlock mMouse{};
+    ControllerBlock mController{};
+
+    // Replay keyboard buffer, KeyboardState points here instead of SDL's array
+    Uint8 mKeys[SDL_NUM_SCANCODES]{};
+};
@@ -17,6 +17,7 @@ class KeyboardState {
 public:
 	// Friend so InputSystem can easily update it
 	friend class InputSystem;
+	friend class InputRecorder;
 
 	// Get just the boolean true/false value of key
 	[[nodiscard]] bool GetKeyValue(SDL_Scancode keyCode) const;
@@ -32,6 +33,7 @@ private:
 class MouseState {
 public:
 	friend class InputSystem;
+	friend class InputRecorder;
 
 	// For buttons
 	[[nodiscard]] bool GetButtonValue(int button) const;
@@ -58,6 +60,7 @@ private:
 class ControllerState {
 public:
 	friend class InputSystem;
+	friend class InputRecorder;
 
 	// For buttons
 	[[nodiscard]] bool GetButtonValue(SDL_GameControllerButton button) const;
@@ -110,6 +113,9 @@ public:
 	void SetRelativeMouseMode(bool value);
 
 private:
+	// Replay overwrites the polled state
+	friend class InputRecorder;
+
 	static float Filter1D(int input);
 	static Vector2 Filter2D(int inputX, int inputY);
 
@@ -0,0 +1,300 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <string>
+#include <SDL.h>
+#include "../helper/Profiler.hpp"
+
+struct JobSystem::Job {
+    JobFunction mFunction;
+    JobCounter *mCounter = nullptr;
+    bool mBackground = false;
+    std::atomic<int> mDependencies{0};  // unfinished predecessors in a graph
+    std::vector<Job *> mSuccessors;
+};
+
+namespace {
+    // Queue of the calling thread, main thread is 0 and threads outside the pool share it
+    thread_local unsigned int tQueueIndex = 0;
+    // Running a background job, what it submits stays in the background queue
+    thread_local bool tInBackgroundJob = false;
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+bool JobSystem::Initialize(unsigned int numWorkers) {
+    if (numWorkers == 0) {
+        unsigned int cores = std::max(std::thread::hardware_concurrency(), 1u);
+        numWorkers = cores - 1;
+    }
+
+    tQueueIndex = 0;
+    for (unsigned int i = 0; i < numWorkers + 1; i++) {
+        mQueues.emplace_back(std::make_unique<WorkQueue>());
+    }
+
+    mRunning = true;
+    for (unsigned int i = 1; i < numWorkers + 1; i++) {
+        mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    SDL_Log("Job system running on %u threads", GetThreadCount());
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!mRunning) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mRunning = false;
+    }
+    mWakeCondition.notify_all();
+    for (auto &worker: mWorkers) {
+        worker.join();
+    }
+    mWorkers.clear();
+
+    // Jobs nobody waited for
+    for (auto &queue: mQueues) {
+        for (auto job: queue->mJobs) {
+            delete job;
+        }
+    }
+    for (auto job: mBackgroundQueue.mJobs) {
+        delete job;
+    }
+    mBackgroundQueue.mJobs.clear();
+    mQueues.clear();
+    mPendingJobs = 0;
+}
+
+unsigned int JobSystem::GetThreadIndex() {
+    return tQueueIndex;
+}
+
+void JobSystem::Submit(JobFunction function, JobCounter *counter) {
+    Job *job = new Job;
+    job->mFunction = std::move(function);
+    job->mCounter = counter;
+    job->mBackground = tInBackgroundJob;
+    if (counter) {
+        counter->mCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    Push(job);
+}
+
+void JobSystem::SubmitBackground(JobFunction function, JobCounter *counter) {
+    Job *job = new Job;
+    job->mFunction = std::move(function);
+    job->mCounter = counter;
+    job->mBackground = true;
+    if (counter) {
+        counter->mCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    Push(job);
+}
+
+void JobSystem::Wait(const JobCounter &counter) {
+    while (!counter.IsDone()) {
+        Job *job = FindJob();
+        if (job) {
+            Execute(job);
+        } else {
+            // Remaining jobs are running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t minBatchSize,
+                            const std::function<void(uint32_t, uint32_t)> &function) {
+    if (count == 0) {
+        return;
+    }
+
+    // A few batches per thread so stealing can even out uneven batches
+    uint32_t batchCount = std::max(GetThreadCount(), 1u) * 4;
+    uint32_t batchSize = std::max({minBatchSize, (count + batchCount - 1) / batchCount, 1u});
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += batchSize) {
+        uint32_t end = std::min(begin + batchSize, count);
+        Submit([&function, begin, end]() { function(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+void JobSystem::WorkerLoop(unsigned int index) {
+    tQueueIndex = index;
+    Profiler::SetThreadName("Worker " + std::to_string(index));
+
+    while (true) {
+        Job *job = FindJob();
+        if (job) {
+            Execute(job);
+            continue;
+        }
+
+        // Sleep until something is submitted
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mWakeCondition.wait(lock, [this]() { return mPendingJobs.load() > 0 || !mRunning; });
+        if (!mRunning) {
+            break;
+        }
+    }
+}
+
+void JobSystem::Push(Job *job) {
+    // Not initialized, run inline
+    if (mQueues.empty()) {
+        Execute(job);
+        return;
+    }
+
+    WorkQueue &queue = job->mBackground ? mBackgroundQueue : *mQueues[tQueueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        queue.mJobs.emplace_back(job);
+    }
+    mPendingJobs.fetch_add(1);
+
+    // Lock so a worker can't miss the wake up between its check and its wait
+    { std::lock_guard<std::mutex> lock(mWakeMutex); }
+    mWakeCondition.notify_one();
+}
+
+JobSystem::Job *JobSystem::FindJob() {
+    if (mQueues.empty()) {
+        return nullptr;
+    }
+
+    // Own queue first, newest job is the most likely to be in cache
+    unsigned int index = tQueueIndex;
+    {
+        WorkQueue &queue = *mQueues[index];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if (!queue.mJobs.empty()) {
+            Job *job = queue.mJobs.back();
+            queue.mJobs.pop_back();
+            mPendingJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Steal the oldest job from other queues
+    for (size_t i = 1; i < mQueues.size(); i++) {
+        WorkQueue &queue = *mQueues[(index + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+        if (!queue.mJobs.empty()) {
+            Job *job = queue.mJobs.front();
+            queue.mJobs.pop_front();
+            mPendingJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Background work last, and only on workers. Without workers the main thread has to run it
+    if (index != 0 || mWorkers.empty()) {
+        std::lock_guard<std::mutex> lock(mBackgroundQueue.mMutex);
+        if (!mBackgroundQueue.mJobs.empty()) {
+            Job *job = mBackgroundQueue.mJobs.front();
+            mBackgroundQueue.mJobs.pop_front();
+            mPendingJobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::Execute(Job *job) {
+    {
+        PROFILE_SCOPE("Job");
+        // A background job may run while a foreground one waits on this thread, restore after
+        bool wasBackground = tInBackgroundJob;
+        tInBackgroundJob = job->mBackground;
+        job->mFunction();
+        tInBackgroundJob = wasBackground;
+    }
+
+    // Release successors before the counter, so a graph is never seen as done too early
+    for (auto successor: job->mSuccessors) {
+        if (successor->mDependencies.fetch_sub(1) == 1) {
+            Push(successor);
+        }
+    }
+    if (job->mCounter) {
+        job->mCounter->mCount.fetch_sub(1, std::memory_order_release);
+    }
+    delete job;
+}
+
+JobGraph::TaskId JobGraph::AddTask(JobSystem::JobFunction function) {
+    mTasks.emplace_back();
+    mTasks.back().mFunction = std::move(function);
+    return static_cast<TaskId>(mTasks.size() - 1);
+}
+
+void JobGraph::AddDependency(TaskId before, TaskId after) {
+    mTasks[before].mSuccessors.emplace_back(after);
+    mTasks[after].mDependencyCount++;
+}
+
+void JobGraph::Run(JobSystem &jobSystem) {
+    if (mTasks.empty()) {
+        return;
+    }
+
+    // A cycle would make Wait spin forever, check it before anything runs (Kahn's algorithm)
+    std::vector<int> dependencies(mTasks.size());
+    std::vector<TaskId> ready;
+    for (size_t i = 0; i < mTasks.size(); i++) {
+        dependencies[i] = mTasks[i].mDependencyCount;
+        if (dependencies[i] == 0) {
+            ready.emplace_back(static_cast<TaskId>(i));
+        }
+    }
+    size_t visited = 0;
+    while (visited < ready.size()) {
+        for (auto successor: mTasks[ready[visited++]].mSuccessors) {
+            if (--dependencies[successor] == 0) {
+                ready.emplace_back(successor);
+            }
+        }
+    }
+    if (visited != mTasks.size()) {
+        SDL_Log("Job graph has a dependency cycle, not running it");
+        return;
+    }
+
+    // Jobs are consumed when executed, so build a fresh set every run
+    JobCounter counter;
+    counter.mCount = static_cast<int>(mTasks.size());
+    std::vector<JobSystem::Job *> jobs(mTasks.size());
+    for (size_t i = 0; i < mTasks.size(); i++) {
+        jobs[i] = new JobSystem::Job;
+        jobs[i]->mFunction = mTasks[i].mFunction;
+        jobs[i]->mCounter = &counter;
+        jobs[i]->mDependencies = mTasks[i].mDependencyCount;
+    }
+    for (size_t i = 0; i < mTasks.size(); i++) {
+        for (auto successor: mTasks[i].mSuccessors) {
+            jobs[i]->mSuccessors.emplace_back(jobs[successor]);
+        }
+    }
+
+    // Roots start right away, the rest are pushed by their last predecessor
+    for (size_t i = 0; i < mTasks.size(); i++) {
+        if (mTasks[i].mDependencyCount == 0) {
+            jobSystem.Push(jobs[i]);
+        }
+    }
+    jobSystem.Wait(counter);
+}
+
+void JobGraph::Clear() {
+    mTasks.clear();
+}
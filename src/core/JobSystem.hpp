@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Count of unfinished jobs, wait on it to join a batch of jobs
+class JobCounter {
+public:
+    [[nodiscard]] bool IsDone() const { return mCount.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    friend class JobGraph;
+    std::atomic<int> mCount{0};
+};
+
+// Engine wide thread pool. Every worker owns a deque, pushes/pops its own jobs at the back
+// and steals from the front of other deques when it runs out of work.
+// The thread calling Wait also runs jobs, so nothing blocks while work is pending.
+// Background jobs (asset loading) go in a separate queue only workers take from, so the main thread
+// never ends up running a long load in the middle of a step
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // 0 workers means one per hardware core minus the main thread
+    bool Initialize(unsigned int numWorkers = 0);
+    void Shutdown();
+
+    // Run function on any thread, counter (optional) is decremented when it finishes
+    void Submit(JobFunction function, JobCounter *counter = nullptr);
+    // Same, on a worker only. Jobs submitted from inside it (ParallelFor) are background jobs too
+    void SubmitBackground(JobFunction function, JobCounter *counter = nullptr);
+    // Help running jobs until all jobs of the counter finished
+    void Wait(const JobCounter &counter);
+
+    // Split [0, count) into batches of at least minBatchSize and wait for all of them,
+    // function receives [begin, end) of one batch
+    void ParallelFor(uint32_t count, uint32_t minBatchSize,
+                     const std::function<void(uint32_t begin, uint32_t end)> &function);
+
+    // Number of threads running jobs, including the calling (main) thread
+    [[nodiscard]] unsigned int GetThreadCount() const { return static_cast<unsigned int>(mQueues.size()); }
+    // Index of the calling thread in [0, GetThreadCount()), main thread is 0
+    static unsigned int GetThreadIndex();
+
+    // Opaque job with dependency links, defined in JobSystem.cpp
+    struct Job;
+
+private:
+    friend class JobGraph;
+
+    struct WorkQueue {
+        std::mutex mMutex;
+        std::deque<Job *> mJobs;
+    };
+
+    void WorkerLoop(unsigned int index);
+    void Push(Job *job);
+    Job *FindJob();
+    void Execute(Job *job);
+
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;  // 0 belong to the main thread
+    WorkQueue mBackgroundQueue;  // shared by all workers, oldest first
+    std::vector<std::thread> mWorkers;
+    std::atomic<int> mPendingJobs{0};  // queued but not started, wakes sleeping workers
+    std::atomic<bool> mRunning{false};
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+};
+
+// Dependency tracked task graph. Add tasks, link them, then Run submits every task
+// whose dependencies finished and returns when the whole graph is done.
+// A graph can be run again after Run returned.
+class JobGraph {
+public:
+    using TaskId = uint32_t;
+
+    TaskId AddTask(JobSystem::JobFunction function);
+    // "after" starts only when "before" finished
+    void AddDependency(TaskId before, TaskId after);
+
+    void Run(JobSystem &jobSystem);
+    void Clear();
+
+private:
+    struct Task {
+        JobSystem::JobFunction mFunction;
+        std::vector<TaskId> mSuccessors;
+        int mDependencyCount = 0;
+    };
+
+    std::vector<Task> mTasks;
+};
@@ -0,0 +1,457 @@
+#include "LevelLoader.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <rapidjson/document.h>
+#include <SDL.h>
+#include "../Game.hpp"
+#include "../actors/Actor.hpp"
+#include "../actors/PlaneActor.hpp"
+#include "../actors/TargetActor.hpp"
+#include "../components/render/MeshComponent.hpp"
+#include "../components/collision/BoxComponent.hpp"
+#include "../components/control/AudioComponent.hpp"
+#include "../helper/Mesh.hpp"
+#include "../helper/Profiler.hpp"
+#include "WorldStreamer.hpp"
+
+namespace {
+    // Json helpers, false if the value isn't an array of numbers with the right size
+    bool ReadFloats(const rapidjson::Value &value, float *out, rapidjson::SizeType count) {
+        if (!value.IsArray() || value.Size() != count) {
+            return false;
+        }
+        for (rapidjson::SizeType i = 0; i < count; i++) {
+            if (!value[i].IsNumber()) {
+                return false;
+            }
+            out[i] = static_cast<float>(value[i].GetDouble());
+        }
+        return true;
+    }
+
+    bool ReadVector3(const rapidjson::Value &value, Vector3 &out) {
+        float v[3];
+        if (!ReadFloats(value, v, 3)) {
+            return false;
+        }
+        out.Set(v[0], v[1], v[2]);
+        return true;
+    }
+
+    // Binary helpers, plain copies of trivially copyable values in native byte order
+    template<typename T>
+    void WriteValue(std::ofstream &file, const T &value) {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool ReadValue(std::ifstream &file, T &value) {
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return static_cast<bool>(file);
+    }
+
+    // Cooked files refer to strings by index in a table stored once
+    uint32_t InternString(std::vector<std::string> &table, std::unordered_map<std::string, uint32_t> &indices,
+                          const std::string &str) {
+        auto iter = indices.find(str);
+        if (iter != indices.end()) {
+            return iter->second;
+        }
+        auto index = static_cast<uint32_t>(table.size());
+        table.emplace_back(str);
+        indices.emplace(str, index);
+        return index;
+    }
+
+    bool ReadString(std::ifstream &file, const std::vector<std::string> &table, std::string &out) {
+        uint32_t index;
+        if (!ReadValue(file, index) || index >= table.size()) {
+            return false;
+        }
+        out = table[index];
+        return true;
+    }
+
+    constexpr uint8_t HAS_ROTATION = 1;
+    constexpr uint8_t HAS_SCALE = 2;
+
+    // Smallest cooked actor: type index, flags, position, rotation, scale, component count
+    constexpr size_t MIN_COOKED_ACTOR_SIZE = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(Vector3) +
+                                             sizeof(Quaternion) + sizeof(float) + sizeof(uint32_t);
+    constexpr size_t COOKED_COMPONENT_SIZE = sizeof(uint32_t) * 2;  // type and asset index
+}
+
+LevelLoader::LevelLoader(Game *game) : mGame(game) {
+    RegisterActorType("Actor", [](Game *g) { return new Actor(g); });
+    RegisterActorType("PlaneActor", [](Game *g) { return new PlaneActor(g); }, {PlaneActor::MESH_FILE});
+    RegisterActorType("TargetActor", [](Game *g) { return new TargetActor(g); }, {TargetActor::MESH_FILE});
+}
+
+void LevelLoader::RegisterActorType(const std::string &type, CreateFunction create,
+                                    std::vector<std::string> meshes) {
+    mActorTypes[type] = {std::move(create), std::move(meshes)};
+}
+
+bool LevelLoader::Load(const std::string &fileName) {
+    PROFILE_SCOPE("LevelLoader::Load");
+    LevelData level;
+    if (!Read(fileName, level)) {
+        return false;
+    }
+
+    if (level.mHasLighting) {
+        Renderer *renderer = mGame->GetRenderer();
+        renderer->SetAmbientLight(level.mAmbientLight);
+        renderer->GetDirectionalLight() = level.mDirLight;
+    }
+
+    size_t actorCount = level.mActors.size();
+    if (level.mCellSize > 0) {
+        mGame->GetWorldStreamer()->SetLevel(std::move(level));
+        SDL_Log("Streaming level %s with %zu actors", fileName.c_str(), actorCount);
+    } else {
+        Instantiate(level.mActors);
+        SDL_Log("Loaded level %s with %zu actors", fileName.c_str(), actorCount);
+    }
+    return true;
+}
+
+bool LevelLoader::Read(const std::string &fileName, LevelData &outLevel) {
+    std::string sourcePath = Game::PROJECT_BASE + fileName;
+    std::string cookedPath = sourcePath + COOKED_EXTENSION;
+
+    // Cooked file is up to date unless the source was edited after it
+    std::error_code error;
+    auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+    bool hasSource = !error;
+    auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+    bool cookedUpToDate = !error && (!hasSource || cookedTime >= sourceTime);
+
+    if (cookedUpToDate && ReadCooked(cookedPath, outLevel)) {
+        return true;
+    }
+
+    outLevel = LevelData();
+    if (!ReadSource(sourcePath, outLevel)) {
+        return false;
+    }
+    // Next load skips json parsing
+    WriteCooked(cookedPath, outLevel);
+    return true;
+}
+
+bool LevelLoader::ReadSource(const std::string &filePath, LevelData &outLevel) {
+    PROFILE_SCOPE("LevelLoader::ReadSource");
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        SDL_Log("Level file %s not found", filePath.c_str());
+        return false;
+    }
+
+    std::stringstream fileStream;
+    fileStream << file.rdbuf();
+    std::string contents = fileStream.str();
+    rapidjson::StringStream jsonStr(contents.c_str());
+    rapidjson::Document doc;
+    doc.ParseStream(jsonStr);
+
+    if (!doc.IsObject()) {
+        SDL_Log("Level %s is not valid json", filePath.c_str());
+        return false;
+    }
+
+    if (!doc.HasMember("version") || !doc["version"].IsInt() || doc["version"].GetInt() != static_cast<int>(VERSION)) {
+        SDL_Log("Level %s not version %u", filePath.c_str(), VERSION);
+        return false;
+    }
+
+    // Lighting is optional, renderer defaults are kept without it
+    if (doc.HasMember("lighting")) {
+        const rapidjson::Value &lighting = doc["lighting"];
+        if (!lighting.IsObject() || !lighting.HasMember("ambient") || !lighting.HasMember("direction") ||
+            !lighting.HasMember("diffuseColor") || !lighting.HasMember("specColor") ||
+            !ReadVector3(lighting["ambient"], outLevel.mAmbientLight) ||
+            !ReadVector3(lighting["direction"], outLevel.mDirLight.mDirection) ||
+            !ReadVector3(lighting["diffuseColor"], outLevel.mDirLight.mDiffuseColor) ||
+            !ReadVector3(lighting["specColor"], outLevel.mDirLight.mSpecColor)) {
+            SDL_Log("Level %s has invalid lighting", filePath.c_str());
+            return false;
+        }
+        outLevel.mHasLighting = true;
+    }
+
+    // Streaming is optional too, whole level is loaded at once without it
+    if (doc.HasMember("streaming")) {
+        const rapidjson::Value &streaming = doc["streaming"];
+        if (!streaming.IsObject() || !streaming.HasMember("cellSize") || !streaming["cellSize"].IsNumber() ||
+            !streaming.HasMember("loadRadius") || !streaming["loadRadius"].IsInt() ||
+            streaming["cellSize"].GetDouble() <= 0 || streaming["loadRadius"].GetInt() < 0) {
+            SDL_Log("Level %s has invalid streaming settings", filePath.c_str());
+            return false;
+        }
+        outLevel.mCellSize = static_cast<float>(streaming["cellSize"].GetDouble());
+        outLevel.mLoadRadius = streaming["loadRadius"].GetInt();
+    }
+
+    if (!doc.HasMember("actors") || !doc["actors"].IsArray()) {
+        SDL_Log("Level %s has no actors array", filePath.c_str());
+        return false;
+    }
+    const rapidjson::Value &actors = doc["actors"];
+    outLevel.mActors.resize(actors.Size());
+    for (rapidjson::SizeType i = 0; i < actors.Size(); i++) {
+        const rapidjson::Value &actorJson = actors[i];
+        LevelActor &actor = outLevel.mActors[i];
+        if (!actorJson.IsObject() || !actorJson.HasMember("type") || !actorJson["type"].IsString()) {
+            SDL_Log("Level %s actor %u has no type", filePath.c_str(), i);
+            return false;
+        }
+        actor.mType = actorJson["type"].GetString();
+
+        if (actorJson.HasMember("position") && !ReadVector3(actorJson["position"], actor.mPosition)) {
+            SDL_Log("Level %s actor %u has invalid position", filePath.c_str(), i);
+            return false;
+        }
+        // Quaternion as [x, y, z, w]
+        if (actorJson.HasMember("rotation")) {
+            float q[4];
+            if (!ReadFloats(actorJson["rotation"], q, 4)) {
+                SDL_Log("Level %s actor %u has invalid rotation", filePath.c_str(), i);
+                return false;
+            }
+            actor.mRotation.Set(q[0], q[1], q[2], q[3]);
+            actor.mHasRotation = true;
+        }
+        if (actorJson.HasMember("scale")) {
+            if (!actorJson["scale"].IsNumber()) {
+                SDL_Log("Level %s actor %u has invalid scale", filePath.c_str(), i);
+                return false;
+            }
+            actor.mScale = static_cast<float>(actorJson["scale"].GetDouble());
+            actor.mHasScale = true;
+        }
+
+        if (!actorJson.HasMember("components")) {
+            continue;
+        }
+        const rapidjson::Value &components = actorJson["components"];
+        if (!components.IsArray()) {
+            SDL_Log("Level %s actor %u has invalid components", filePath.c_str(), i);
+            return false;
+        }
+        for (rapidjson::SizeType j = 0; j < components.Size(); j++) {
+            const rapidjson::Value &compJson = components[j];
+            if (!compJson.IsObject() || !compJson.HasMember("type") || !compJson["type"].IsString() ||
+                !compJson.HasMember("asset") || !compJson["asset"].IsString()) {
+                SDL_Log("Level %s actor %u has invalid component %u", filePath.c_str(), i, j);
+                return false;
+            }
+            actor.mComponents.push_back({compJson["type"].GetString(), compJson["asset"].GetString()});
+        }
+    }
+    return true;
+}
+
+bool LevelLoader::ReadCooked(const std::string &filePath, LevelData &outLevel) {
+    PROFILE_SCOPE("LevelLoader::ReadCooked");
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    // Counts are checked against what's left before sizing anything, a bad file can't ask for gigabytes
+    auto fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    auto remaining = [&]() { return fileSize - static_cast<size_t>(file.tellg()); };
+
+    uint32_t magic, version;
+    if (!ReadValue(file, magic) || !ReadValue(file, version) || magic != COOKED_MAGIC || version != COOKED_VERSION) {
+        SDL_Log("Cooked level %s has wrong format or version", filePath.c_str());
+        return false;
+    }
+
+    uint8_t hasLighting;
+    int32_t loadRadius;
+    if (!ReadValue(file, outLevel.mCellSize) || !ReadValue(file, loadRadius) || !ReadValue(file, hasLighting) || !ReadValue(file, outLevel.mAmbientLight) ||
+        !ReadValue(file, outLevel.mDirLight)) {
+        SDL_Log("Cooked level %s is truncated", filePath.c_str());
+        return false;
+    }
+    // Same limits as the source streaming settings, cell size 0 is a level without them
+    if (!std::isfinite(outLevel.mCellSize) || outLevel.mCellSize < 0 || loadRadius < 0) {
+        SDL_Log("Cooked level %s has wrong format or version", filePath.c_str());
+        return false;
+    }
+    outLevel.mLoadRadius = loadRadius;
+    outLevel.mHasLighting = hasLighting != 0;
+
+    // String table
+    uint32_t stringCount;
+    if (!ReadValue(file, stringCount) || stringCount > remaining() / sizeof(uint32_t)) {
+        SDL_Log("Cooked level %s is truncated", filePath.c_str());
+        return false;
+    }
+    std::vector<std::string> strings(stringCount);
+    for (auto &str: strings) {
+        uint32_t length;
+        if (!ReadValue(file, length) || length > remaining()) {
+            SDL_Log("Cooked level %s is truncated", filePath.c_str());
+            return false;
+        }
+        str.resize(length);
+        if (!file.read(&str[0], length)) {
+            SDL_Log("Cooked level %s is truncated", filePath.c_str());
+            return false;
+        }
+    }
+
+    uint32_t actorCount;
+    if (!ReadValue(file, actorCount) || actorCount > remaining() / MIN_COOKED_ACTOR_SIZE) {
+        SDL_Log("Cooked level %s is truncated", filePath.c_str());
+        return false;
+    }
+    outLevel.mActors.resize(actorCount);
+    for (auto &actor: outLevel.mActors) {
+        uint8_t flags;
+        uint32_t componentCount;
+        if (!ReadString(file, strings, actor.mType) || !ReadValue(file, flags) ||
+            !ReadValue(file, actor.mPosition) || !ReadValue(file, actor.mRotation) ||
+            !ReadValue(file, actor.mScale) || !ReadValue(file, componentCount) ||
+            componentCount > remaining() / COOKED_COMPONENT_SIZE) {
+            SDL_Log("Cooked level %s is corrupted", filePath.c_str());
+            return false;
+        }
+        actor.mHasRotation = flags & HAS_ROTATION;
+        actor.mHasScale = flags & HAS_SCALE;
+
+        actor.mComponents.resize(componentCount);
+        for (auto &component: actor.mComponents) {
+            if (!ReadString(file, strings, component.mType) || !ReadString(file, strings, component.mAsset)) {
+                SDL_Log("Cooked level %s is corrupted", filePath.c_str());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool LevelLoader::WriteCooked(const std::string &filePath, const LevelData &level) {
+    PROFILE_SCOPE("LevelLoader::WriteCooked");
+    // Collect strings first, they are written before the actors
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> indices;
+    for (const auto &actor: level.mActors) {
+        InternString(strings, indices, actor.mType);
+        for (const auto &component: actor.mComponents) {
+            InternString(strings, indices, component.mType);
+            InternString(strings, indices, component.mAsset);
+        }
+    }
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        SDL_Log("Can't write cooked level %s", filePath.c_str());
+        return false;
+    }
+
+    WriteValue(file, COOKED_MAGIC);
+    WriteValue(file, COOKED_VERSION);
+    WriteValue(file, level.mCellSize);
+    WriteValue(file, static_cast<int32_t>(level.mLoadRadius));
+    WriteValue(file, static_cast<uint8_t>(level.mHasLighting));
+    WriteValue(file, level.mAmbientLight);
+    WriteValue(file, level.mDirLight);
+
+    WriteValue(file, static_cast<uint32_t>(strings.size()));
+    for (const auto &str: strings) {
+        WriteValue(file, static_cast<uint32_t>(str.size()));
+        file.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+
+    WriteValue(file, static_cast<uint32_t>(level.mActors.size()));
+    for (const auto &actor: level.mActors) {
+        uint8_t flags = (actor.mHasRotation ? HAS_ROTATION : 0) | (actor.mHasScale ? HAS_SCALE : 0);
+        WriteValue(file, indices[actor.mType]);
+        WriteValue(file, flags);
+        WriteValue(file, actor.mPosition);
+        WriteValue(file, actor.mRotation);
+        WriteValue(file, actor.mScale);
+        WriteValue(file, static_cast<uint32_t>(actor.mComponents.size()));
+        for (const auto &component: actor.mComponents) {
+            WriteValue(file, indices[component.mType]);
+            WriteValue(file, indices[component.mAsset]);
+        }
+    }
+
+    if (!file) {
+        SDL_Log("Failed writing cooked level %s", filePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void LevelLoader::Instantiate(const std::vector<LevelActor> &actors) {
+    PROFILE_SCOPE("LevelLoader::Instantiate");
+    // Every mesh an actor will ask for, so no file is loaded while creating actors
+    std::vector<std::string> meshes;
+    for (const auto &entry: actors) {
+        CollectMeshes(entry, meshes);
+    }
+    mGame->GetRenderer()->PreloadAssets(meshes, {}, mGame->GetJobSystem());
+
+    // Grow actor and transform storage once for the whole level
+    mGame->ReserveActors(actors.size());
+    for (const auto &entry: actors) {
+        CreateActor(entry);
+    }
+}
+
+void LevelLoader::CollectMeshes(const LevelActor &entry, std::vector<std::string> &outMeshes) const {
+    auto iter = mActorTypes.find(entry.mType);
+    if (iter != mActorTypes.end()) {
+        outMeshes.insert(outMeshes.end(), iter->second.mMeshes.begin(), iter->second.mMeshes.end());
+    }
+    for (const auto &component: entry.mComponents) {
+        if (component.mType == "MeshComponent" || component.mType == "BoxComponent") {
+            outMeshes.emplace_back(component.mAsset);
+        }
+    }
+}
+
+Actor *LevelLoader::CreateActor(const LevelActor &entry) {
+    auto iter = mActorTypes.find(entry.mType);
+    if (iter == mActorTypes.end()) {
+        SDL_Log("Unknown actor type %s in level", entry.mType.c_str());
+        return nullptr;
+    }
+
+    Actor *actor = iter->second.mCreate(mGame);
+    actor->SetPosition(entry.mPosition);
+    if (entry.mHasRotation) {
+        actor->SetRotation(entry.mRotation);
+    }
+    if (entry.mHasScale) {
+        actor->SetScale(entry.mScale);
+    }
+
+    Renderer *renderer = mGame->GetRenderer();
+    for (const auto &component: entry.mComponents) {
+        if (component.mType == "MeshComponent") {
+            auto *mc = new MeshComponent(actor);
+            mc->SetMesh(renderer->GetMesh(component.mAsset));
+        } else if (component.mType == "BoxComponent") {
+            Mesh *mesh = renderer->GetMesh(component.mAsset);
+            if (mesh) {
+                auto *bc = new BoxComponent(actor);
+                bc->SetObjectBox(mesh->GetBox());
+            }
+        } else if (component.mType == "AudioComponent") {
+            auto *ac = new AudioComponent(actor);
+            ac->PlayEvent(component.mAsset);
+        } else {
+            SDL_Log("Unknown component type %s in level", component.mType.c_str());
+        }
+    }
+    return actor;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../helper/Math.hpp"
+#include "Renderer.hpp"
+
+// Level content, same for the json source and the cooked binary
+struct LevelComponent {
+    std::string mType;  // MeshComponent, BoxComponent or AudioComponent
+    std::string mAsset;  // mesh file for mesh/box, event name for audio
+};
+
+struct LevelActor {
+    std::string mType;  // registered actor type
+    Vector3 mPosition = Vector3::Zero;
+    Quaternion mRotation;
+    float mScale = 1.0f;
+    // Keep the rotation/scale set by the actor type otherwise
+    bool mHasRotation = false;
+    bool mHasScale = false;
+    std::vector<LevelComponent> mComponents;
+};
+
+struct LevelData {
+    // Streamed in cells around the player when cell size > 0, see WorldStreamer
+    float mCellSize = 0;
+    int mLoadRadius = 1;  // in cells
+    bool mHasLighting = false;
+    Vector3 mAmbientLight = Vector3::Zero;
+    DirectionalLight mDirLight{};
+    std::vector<LevelActor> mActors;
+};
+
+// Load levels made of actors, components, transforms and asset references.
+// Every mesh/texture of the level is loaded on the job system first, then all actors are created in one batch.
+// Streamed levels are handed to the game's WorldStreamer instead.
+// Source is json (.gplevel), it is cooked into a binary file next to it (.gplevelbin) on first load
+class LevelLoader {
+public:
+    explicit LevelLoader(class Game* game);
+
+    bool Load(const std::string& fileName);
+    // Read the cooked file if up to date, otherwise the source (and cook it)
+    bool Read(const std::string& fileName, LevelData& outLevel);
+    // Preload assets then create all actors
+    void Instantiate(const std::vector<LevelActor>& actors);
+
+    // One actor and its components, its meshes should be loaded already. nullptr for unknown type
+    class Actor* CreateActor(const LevelActor& entry);
+    // Meshes CreateActor will ask the renderer for
+    void CollectMeshes(const LevelActor& entry, std::vector<std::string>& outMeshes) const;
+
+    // Native actor types a level can place, with the meshes their constructor loads
+    using CreateFunction = std::function<class Actor*(class Game*)>;
+    void RegisterActorType(const std::string& type, CreateFunction create,
+                           std::vector<std::string> meshes = {});
+
+    // Both take full path
+    static bool ReadSource(const std::string& filePath, LevelData& outLevel);
+    static bool ReadCooked(const std::string& filePath, LevelData& outLevel);
+    static bool WriteCooked(const std::string& filePath, const LevelData& level);
+
+    constexpr static const char* COOKED_EXTENSION = "bin";  // appended to the source name
+
+private:
+    struct ActorType {
+        CreateFunction mCreate;
+        std::vector<std::string> mMeshes;
+    };
+    std::unordered_map<std::string, ActorType> mActorTypes;
+
+    class Game* mGame = nullptr;
+
+    constexpr static uint32_t COOKED_MAGIC = 0x564C5047;  // "GPLV"
+    constexpr static uint32_t VERSION = 1;
+    constexpr static uint32_t COOKED_VERSION = 2;
+};
@@ -0,0 +1,47 @@
+#include "NullRenderer.hpp"
+#include <SDL.h>
+#include "../helper/Texture.hpp"
+
+NullRenderer::NullRenderer(Game *game) : Renderer(game) {}
+
+bool NullRenderer::Initialize(float screenWidth, float screenHeight) {
+    mScreenWidth = screenWidth;
+    mScreenHeight = screenHeight;
+
+    // Same view/projection as GL renderer, gameplay still un-projects through it
+    mView = Matrix4::CreateLookAt(Vector3::Zero, Vector3::UnitX, Vector3::UnitZ);
+    mProjection = Matrix4::CreatePerspectiveFOV(Math::ToRadians(70.0f),
+                                                mScreenWidth, mScreenHeight, 25.0f, 10000.0f);
+
+    SDL_Log("Running with null renderer");
+    return true;
+}
+
+void NullRenderer::Shutdown() {
+
+}
+
+void NullRenderer::Draw(float alpha) {
+
+}
+
+bool NullRenderer::DecodeTexture(Texture *tex, const std::string &filePath) {
+    return tex->LoadDimensions(filePath);
+}
+
+Texture *NullRenderer::CreateTextureFromSurface(SDL_Surface *surface) {
+    auto *tex = new Texture();
+    tex->SetDimensions(surface->w, surface->h);
+    return tex;
+}
+
+Texture *NullRenderer::CreateTextureFromPixels(const unsigned char *pixels, int width, int height) {
+    auto *tex = new Texture();
+    tex->SetDimensions(width, height);
+    return tex;
+}
+
+VertexArray *NullRenderer::CreateVertexArray(const float *verts, unsigned int numVerts,
+                                             const unsigned int *indices, unsigned int numIndices) {
+    return nullptr;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+// Renderer without window or GL context (servers, CI, benchmarks).
+// Meshes and textures still load their metadata (bounds, dimensions) so gameplay works the same.
+class NullRenderer : public Renderer {
+public:
+    explicit NullRenderer(class Game* game);
+
+    bool Initialize(float screenWidth, float screenHeight) override;
+    void Shutdown() override;
+    void Draw(float alpha) override;
+
+    // No shaders in headless mode
+    void AddMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName) override {}
+    void RemoveMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName) override {}
+
+    bool DecodeTexture(class Texture* tex, const std::string& filePath) override;
+    void UploadTexture(class Texture* tex) override {}
+    class Texture* CreateTextureFromSurface(struct SDL_Surface* surface) override;
+    class Texture* CreateTextureFromPixels(const unsigned char* pixels, int width, int height) override;
+    class VertexArray* CreateVertexArray(const float* verts, unsigned int numVerts,
+                                         const unsigned int* indices, unsigned int numIndices) override;
+};
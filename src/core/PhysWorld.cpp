@@ -2,10 +2,13 @@
 #include <algorithm>
 #include <SDL.h>
 #include "../components/collision/BoxComponent.hpp"
+#include "../Game.hpp"
+#include "../helper/Profiler.hpp"
 
 PhysWorld::PhysWorld(Game *game) : mGame(game) {}
 
 bool PhysWorld::SegmentCast(const LineSegment &l, CollisionInfo &outColl) {
+    PROFILE_SCOPE("PhysWorld::SegmentCast");
     bool collided = false;
     // Initialize closestT to infinity, so first
     // intersection will always update closestT
@@ -13,17 +16,20 @@ bool PhysWorld::SegmentCast(const LineSegment &l, CollisionInfo &outColl) {
     Vector3 norm{};
 
     // Test against all boxes, pick the closest collision
-    for (auto box: mBoxes) {
+    // During parallel actor update this is the buffered copy, owners are writing the live boxes
+    const BoxTable &boxes = mGame->GetEntityStorage().GetBoxes();
+    const std::vector<AABB> &worldBoxes = mGame->GetEntityStorage().GetReadWorldBoxes();
+    for (size_t i = 0; i < worldBoxes.size(); i++) {
         float t;
         // Does the segment intersect with the box?
-        if (Intersect(l, box->GetWorldBox(), t, norm)) {
+        if (Intersect(l, worldBoxes[i], t, norm)) {
             // Is this closer than previous intersection?
             if (t < closestT) {
                 closestT = t;
                 outColl.mPoint = l.PointOnSegment(t);
                 outColl.mNormal = norm;
-                outColl.mBox = box;
-                outColl.mActor = box->GetOwner();
+                outColl.mBox = boxes.mComponents[i];
+                outColl.mActor = boxes.mComponents[i]->GetOwner();
                 collided = true;
             }
         }
@@ -33,55 +39,49 @@ bool PhysWorld::SegmentCast(const LineSegment &l, CollisionInfo &outColl) {
 }
 
 void PhysWorld::TestPairwise(std::function<void(Actor * , Actor * )> f) {
+    const BoxTable &boxes = mGame->GetEntityStorage().GetBoxes();
+    const std::vector<AABB> &worldBoxes = mGame->GetEntityStorage().GetReadWorldBoxes();
     // Naive implementation O(n^2)
-    for (size_t i = 0; i < mBoxes.size(); i++) {
+    for (size_t i = 0; i < worldBoxes.size(); i++) {
         // Don't need to test vs itself and any previous i values
-        for (size_t j = i + 1; j < mBoxes.size(); j++) {
-            BoxComponent *a = mBoxes[i];
-            BoxComponent *b = mBoxes[j];
-            if (Intersect(a->GetWorldBox(), b->GetWorldBox())) {
+        for (size_t j = i + 1; j < worldBoxes.size(); j++) {
+            if (Intersect(worldBoxes[i], worldBoxes[j])) {
                 // Call supplied function to handle intersection
-                f(a->GetOwner(), b->GetOwner());
+                f(boxes.mComponents[i]->GetOwner(), boxes.mComponents[j]->GetOwner());
             }
         }
     }
 }
 
 void PhysWorld::TestSweepAndPrune(std::function<void(Actor * , Actor * )> f) {
-    // Sort by min.x
-    std::sort(mBoxes.begin(), mBoxes.end(),
-              [](BoxComponent *a, BoxComponent *b) {
-                  return a->GetWorldBox().mMin.x <
-                         b->GetWorldBox().mMin.x;
+    const BoxTable &boxes = mGame->GetEntityStorage().GetBoxes();
+    const std::vector<AABB> &worldBoxes = mGame->GetEntityStorage().GetReadWorldBoxes();
+
+    // Sort rows by min.x, the table itself must keep its order
+    mSortedRows.resize(worldBoxes.size());
+    for (uint32_t i = 0; i < mSortedRows.size(); i++) {
+        mSortedRows[i] = i;
+    }
+    std::sort(mSortedRows.begin(), mSortedRows.end(),
+              [&worldBoxes](uint32_t a, uint32_t b) {
+                  return worldBoxes[a].mMin.x <
+                         worldBoxes[b].mMin.x;
               });
 
-    for (size_t i = 0; i < mBoxes.size(); i++) {
+    for (size_t i = 0; i < mSortedRows.size(); i++) {
         // Get max.x for current box
-        BoxComponent *a = mBoxes[i];
-        float max = a->GetWorldBox().mMax.x;
-        for (size_t j = i + 1; j < mBoxes.size(); j++) {
-            BoxComponent *b = mBoxes[j];
+        const AABB &a = worldBoxes[mSortedRows[i]];
+        float max = a.mMax.x;
+        for (size_t j = i + 1; j < mSortedRows.size(); j++) {
+            const AABB &b = worldBoxes[mSortedRows[j]];
             // If AABB[j] min is past the max bounds of AABB[i],
             // then there aren't any other possible intersections
             // against AABB[i]
-            if (b->GetWorldBox().mMin.x > max) {
+            if (b.mMin.x > max) {
                 break;
-            } else if (Intersect(a->GetWorldBox(), b->GetWorldBox())) {
-                f(a->GetOwner(), b->GetOwner());
+            } else if (Intersect(a, b)) {
+                f(boxes.mComponents[mSortedRows[i]]->GetOwner(), boxes.mComponents[mSortedRows[j]]->GetOwner());
             }
         }
     }
 }
-
-void PhysWorld::AddBox(BoxComponent *box) {
-    mBoxes.emplace_back(box);
-}
-
-void PhysWorld::RemoveBox(BoxComponent *box) {
-    auto iter = std::find(mBoxes.begin(), mBoxes.end(), box);
-    if (iter != mBoxes.end()) {
-        // Swap to end of vector and pop off (avoid erase copies)
-        std::iter_swap(iter, mBoxes.end() - 1);
-        mBoxes.pop_back();
-    }
-}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include "../helper/Math.hpp"
@@ -29,11 +30,8 @@ public:
 	// Test collisions using sweep and prune
 	void TestSweepAndPrune(std::function<void(class Actor*, class Actor*)> f);
 
-	// Add/remove box components from world, function similar to sprite components
-	void AddBox(class BoxComponent* box);
-	void RemoveBox(class BoxComponent* box);
-
 private:
+	// Boxes are read straight from the entity storage box table
 	class Game* mGame;
-	std::vector<class BoxComponent*> mBoxes;
+	std::vector<uint32_t> mSortedRows;  // sweep and prune order, reused between calls
 };
@@ -0,0 +1,40 @@
+#include "RenderQueue.hpp"
+#include <algorithm>
+
+uint64_t RenderQueue::MakeKey(Pass pass, uint32_t shader, uint32_t texture, uint32_t vertexArray, float depth) {
+    auto field = [](uint32_t value, int bits) { return static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1); };
+    auto depthBits = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>((1 << DEPTH_BITS) - 1));
+    return static_cast<uint64_t>(pass) << PASS_SHIFT |
+           field(shader, SHADER_BITS) << SHADER_SHIFT |
+           field(texture, TEXTURE_BITS) << TEXTURE_SHIFT |
+           field(vertexArray, VERTEX_ARRAY_BITS) << VERTEX_ARRAY_SHIFT |
+           field(depthBits, DEPTH_BITS);
+}
+
+void RenderQueue::Sort() {
+    if (mItems.size() < 2) {
+        return;
+    }
+    mScratch.resize(mItems.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const auto &item: mItems) {
+            counts[(item.mKey >> shift) & 0xFF]++;
+        }
+        if (counts[(mItems[0].mKey >> shift) & 0xFF] == mItems.size()) {
+            continue;  // nothing to reorder on this byte
+        }
+
+        // Counts to start offsets, then scatter in order
+        size_t offset = 0;
+        for (auto &count: counts) {
+            size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for (const auto &item: mItems) {
+            mScratch[counts[(item.mKey >> shift) & 0xFF]++] = item;
+        }
+        mItems.swap(mScratch);
+    }
+}
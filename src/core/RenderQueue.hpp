@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Draws of a frame as 64 bit sort keys, radix sorted so draws sharing state end up next to each other.
+// Key from high to low bits: pass, shader, texture, vertex array, depth
+class RenderQueue {
+public:
+    enum Pass {
+        EDepthPrepass,  // depth only, no color writes
+        EOpaque
+    };
+
+    struct Item {
+        uint64_t mKey;
+        uint32_t mIndex;  // caller's draw index
+    };
+
+    // Ids are truncated to their field, a collision only costs extra state changes.
+    // Depth is in [0, 1], 0 at the camera
+    static uint64_t MakeKey(Pass pass, uint32_t shader, uint32_t texture, uint32_t vertexArray, float depth);
+    [[nodiscard]] static Pass GetPass(uint64_t key) { return static_cast<Pass>(key >> PASS_SHIFT); }
+
+    void Clear() { mItems.clear(); }
+    void Push(uint64_t key, uint32_t index) { mItems.push_back({key, index}); }
+    // Stable LSD radix sort, 8 bits per pass, passes where every key has the same byte are skipped
+    void Sort();
+
+    [[nodiscard]] const std::vector<Item>& GetItems() const { return mItems; }
+
+private:
+    std::vector<Item> mItems;
+    std::vector<Item> mScratch;
+
+    constexpr static int DEPTH_BITS = 24;
+    constexpr static int VERTEX_ARRAY_BITS = 13;
+    constexpr static int TEXTURE_BITS = 13;
+    constexpr static int SHADER_BITS = 10;
+    constexpr static int VERTEX_ARRAY_SHIFT = DEPTH_BITS;
+    constexpr static int TEXTURE_SHIFT = VERTEX_ARRAY_SHIFT + VERTEX_ARRAY_BITS;
+    constexpr static int SHADER_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+    constexpr static int PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+    static_assert(PASS_SHIFT + 4 == 64, "sort key fields must fill 64 bits");
+};
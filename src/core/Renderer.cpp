@@ -1,14 +1,48 @@
 #include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <rapidjson/document.h>
 #include "Renderer.hpp"
 #include "../helper/Texture.hpp"
 #include "../helper/Mesh.hpp"
 #include "Shader.hpp"
+#include "JobSystem.hpp"
 #include "../helper/VertexArray.hpp"
+#include "../helper/UniformBuffer.hpp"
+#include "../helper/SpriteBatch.hpp"
+#include "../helper/RectPacker.hpp"
+#include "../helper/RingBuffer.hpp"
 #include "../Game.hpp"
 #include "../components/render/SpriteComponent.hpp"
 #include "../components/render/MeshComponent.hpp"
+#include "../actors/Actor.hpp"
 #include "../audio/AudioSystem.hpp"
 #include "../ui/UIScreen.hpp"
+#include "../helper/Profiler.hpp"
+
+// Fresh copy of a mesh or texture being parsed for hot reload
+struct Renderer::PendingReload {
+    std::string mFilePath;  // cache key
+    Mesh *mMesh = nullptr;
+    Texture *mTexture = nullptr;
+    bool mLoaded = false;
+    JobCounter mJob;
+};
+
+struct Renderer::StaticBatch {
+    ~StaticBatch() { delete mVertexArray; }
+
+    Shader *mShader = nullptr;
+    Texture *mTexture = nullptr;
+    float mSpecPower = 0;
+    int mX = 0;
+    int mY = 0;
+    std::vector<MeshComponent *> mComponents;
+    VertexArray *mVertexArray = nullptr;
+    AABB mBox{Vector3::Infinity, Vector3::NegInfinity};  // world space
+    bool mDirty = true;
+};
 
 Renderer::Renderer(Game* game) : mGame(game) {}
 
@@ -44,6 +78,8 @@ bool Renderer::Initialize(float screenWidth, float screenHeight) {
 
     // Create an OpenGL context
     mContext = SDL_GL_CreateContext(mWindow);
+    // Sync buffer swap with the display, simulation no longer limits the frame rate
+    SDL_GL_SetSwapInterval(1);
 
     // Initialize glad and make all extension function supported available
     // Load GL extensions using glad
@@ -59,20 +95,30 @@ bool Renderer::Initialize(float screenWidth, float screenHeight) {
     // so clear it
     glGetError();
 
+    // Per frame data is written into persistently mapped memory when the driver supports it
+    if (SDL_GL_ExtensionSupported("GL_ARB_buffer_storage")) {
+        RingBuffer::SetBufferStorage(SDL_GL_GetProcAddress("glBufferStorage"));
+    }
+    mFrameData = new RingBuffer(FRAME_DATA_SIZE);
+    SDL_Log("Per frame data %s", mFrameData->IsPersistent() ? "persistently mapped" : "mapped per write");
+
     // Make sure we can create/compile shaders
     if (!LoadShaders()) {
         SDL_Log("Failed to load shaders.");
         return false;
     }
 
-    // Create quad for drawing sprites
-    CreateSpriteVerts();
+    // Sprites and UI are collected into one vertex upload per pass
+    mSpriteBatch = new SpriteBatch(mFrameData);
 
     return true;
 }
 
 void Renderer::Shutdown() {
-    delete mSpriteVerts;
+    mStaticBatches.clear();
+    delete mSpriteBatch;
+    delete mFrameUniformBuffer;
+    delete mFrameData;
     mSpriteShader->Unload();
     delete mSpriteShader;
 
@@ -87,12 +133,27 @@ void Renderer::Shutdown() {
 }
 
 void Renderer::UnloadData() {
+    WaitPendingReloads();
+
+    // Actors are gone, so are the components in static batches
+    mStaticBatches.clear();
+    mStaticBatchOf.clear();
+    mPendingStatic.clear();
+
     // Destroy textures
     for (auto i : mTextures) {
         i.second->Unload();
         delete i.second;
     }
     mTextures.clear();
+    mPinnedTextures.clear();
+    // After their regions, which don't own the GL texture
+    for (auto atlas : mAtlases) {
+        atlas->Unload();
+        delete atlas;
+    }
+    mAtlases.clear();
+    mSortIds.clear();
 
     // Destroy meshes
     for (auto i : mMeshes) {
@@ -102,7 +163,10 @@ void Renderer::UnloadData() {
     mMeshes.clear();
 }
 
-void Renderer::Draw() {
+void Renderer::Draw(float alpha) {
+    PROFILE_SCOPE("Renderer::Draw");
+    // Wait until the GPU is done with the frame that used this section of the ring buffer
+    mFrameData->BeginFrame();
     // Calculate current color
     // Set draw colour, clear back buffer to current colour
     glClearColor(0.8f, 0.8f, 0.8f, 1.0f);
@@ -116,21 +180,10 @@ void Renderer::Draw() {
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_BLEND);
 
-    // Group shader render
-    auto viewProjectionCache = mView * mProjection;
-    for (const auto &shaderGroup : mShaderGroup) {
-        // Set mesh shader active, update view matrix
-        auto &curShader = shaderGroup.first;
-        curShader->SetActive();
-        curShader->SetMatrixUniform("uViewProj", viewProjectionCache);
+    // Camera and lights once per frame for every shader
+    UpdateFrameUniforms();
 
-        // Update lighting uniforms
-        SetLightUniforms(curShader);
-        for (auto mc : shaderGroup.second) {
-            if (mc->GetVisible())
-                mc->Draw(curShader);
-        }
-    }
+    DrawMeshes(alpha);
 
     // Draw all sprite components
     // Disable depth buffering & enable blend mode for sprite
@@ -143,18 +196,22 @@ void Renderer::Draw() {
     glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
 
-    // Set shader/vao as active
+    // Sprites sorted by draw order, a few draws for all of them
     mSpriteShader->SetActive();
-    mSpriteVerts->SetActive();
+    mSpriteBatch->Begin();
     for (auto sprite : mSprites) {
         if (sprite->GetVisible())
-            sprite->Draw(mSpriteShader);
+            sprite->Draw(mSpriteBatch);
     }
+    mSpriteBatch->End();
 
-    // Share same shader as sprite, draw UI
+    // Share same shader as sprite, draw UI on top
+    mSpriteBatch->Begin();
     for (auto ui : mGame->GetUIStack()) {
-        ui->Draw(mSpriteShader);
+        ui->Draw(mSpriteBatch);
     }
+    mSpriteBatch->End();
+    mFrameData->EndFrame();
 
     // Swap the buffers
     SDL_GL_SwapWindow(mWindow);
@@ -190,6 +247,14 @@ void Renderer::RemoveMeshComp(MeshComponent* mesh) {
 }
 
 Texture* Renderer::GetTexture(const std::string& fileName) {
+    Texture *tex = GetMeshTexture(fileName);
+    if (tex) {
+        mPinnedTextures.emplace(tex);
+    }
+    return tex;
+}
+
+Texture* Renderer::GetMeshTexture(const std::string& fileName) {
     Texture *tex = nullptr;
 
     std::string filePath = Game::PROJECT_BASE + fileName;
@@ -198,12 +263,9 @@ Texture* Renderer::GetTexture(const std::string& fileName) {
     if (iter != mTextures.end()) {
         tex = iter->second;
     } else {
-        tex = new Texture();
-        if (tex->Load(filePath)) {
+        tex = CreateTexture(filePath);
+        if (tex) {
             mTextures.emplace(filePath, tex);
-        } else {
-            delete tex;
-            tex = nullptr;
         }
     }
     return tex;
@@ -229,6 +291,423 @@ Mesh* Renderer::GetMesh(const std::string &fileName) {
     return m;
 }
 
+void Renderer::UnloadMesh(const std::string &fileName) {
+    auto iter = mMeshes.find(Game::PROJECT_BASE + fileName);
+    if (iter == mMeshes.end()) {
+        return;
+    }
+    Mesh *mesh = iter->second;
+    for (auto mc: mMeshComps) {
+        if (mc->GetMesh() == mesh) {
+            return;
+        }
+    }
+    mMeshes.erase(iter);
+
+    // Its textures, unless someone else holds them
+    for (size_t i = 0; Texture *tex = mesh->GetTexture(i); i++) {
+        if (mPinnedTextures.count(tex)) {
+            continue;
+        }
+        bool shared = false;
+        for (const auto &other: mMeshes) {
+            for (size_t j = 0; Texture *otherTex = other.second->GetTexture(j); j++) {
+                shared = shared || otherTex == tex;
+            }
+        }
+        if (shared) {
+            continue;
+        }
+        for (auto texIter = mTextures.begin(); texIter != mTextures.end(); ++texIter) {
+            if (texIter->second == tex) {
+                mTextures.erase(texIter);
+                mSortIds.erase(tex);
+                tex->Unload();
+                delete tex;
+                break;
+            }
+        }
+    }
+
+    mSortIds.erase(mesh->GetVertexArray());
+    mesh->Unload();
+    delete mesh;
+}
+
+void Renderer::BeginAssetLoad(AssetLoad &load, const std::vector<std::string> &meshNames,
+                              const std::vector<std::string> &textureNames) const {
+    // Meshes and textures not in the cache, each once
+    for (const auto &name: meshNames) {
+        std::string filePath = Game::PROJECT_BASE + name;
+        if (mMeshes.find(filePath) == mMeshes.end() &&
+            std::find(load.mMeshPaths.begin(), load.mMeshPaths.end(), filePath) == load.mMeshPaths.end()) {
+            load.mMeshPaths.emplace_back(filePath);
+        }
+    }
+    for (const auto &name: textureNames) {
+        std::string filePath = Game::PROJECT_BASE + name;
+        if (std::find(load.mTexturePaths.begin(), load.mTexturePaths.end(), filePath) == load.mTexturePaths.end()) {
+            load.mTexturePaths.emplace_back(filePath);
+        }
+    }
+    load.mRequestedTextures = load.mTexturePaths.size();
+
+    // Decode can't look at the cache from another thread
+    for (const auto &texture: mTextures) {
+        load.mCachedTextures.emplace(texture.first);
+    }
+}
+
+void Renderer::DecodeAssets(AssetLoad &load, JobSystem &jobSystem) {
+    PROFILE_SCOPE("Renderer::DecodeAssets");
+    load.mMeshes.resize(load.mMeshPaths.size());
+    load.mMeshLoaded.resize(load.mMeshPaths.size());
+    jobSystem.ParallelFor(static_cast<uint32_t>(load.mMeshPaths.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            load.mMeshes[i] = new Mesh();
+            load.mMeshLoaded[i] = load.mMeshes[i]->Parse(load.mMeshPaths[i]);
+        }
+    });
+
+    // Textures the parsed meshes use, requested ones are loaded even if cached (FinishAssetLoad pins them)
+    for (size_t i = 0; i < load.mMeshes.size(); i++) {
+        if (!load.mMeshLoaded[i]) {
+            continue;
+        }
+        for (const auto &name: load.mMeshes[i]->GetTextureNames()) {
+            std::string filePath = Game::PROJECT_BASE + name;
+            if (load.mCachedTextures.find(filePath) == load.mCachedTextures.end() &&
+                std::find(load.mTexturePaths.begin(), load.mTexturePaths.end(), filePath) == load.mTexturePaths.end()) {
+                load.mTexturePaths.emplace_back(filePath);
+            }
+        }
+    }
+
+    load.mTextures.resize(load.mTexturePaths.size());
+    load.mTextureLoaded.resize(load.mTexturePaths.size());
+    jobSystem.ParallelFor(static_cast<uint32_t>(load.mTexturePaths.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            if (i < load.mRequestedTextures && load.mCachedTextures.count(load.mTexturePaths[i])) {
+                continue;  // only needs pinning
+            }
+            load.mTextures[i] = new Texture();
+            load.mTextureLoaded[i] = DecodeTexture(load.mTextures[i], load.mTexturePaths[i]);
+        }
+    });
+}
+
+void Renderer::FinishAssetLoad(AssetLoad &load) {
+    PROFILE_SCOPE("Renderer::FinishAssetLoad");
+    // GL context belongs to this thread, upload here. Textures first, meshes look them up.
+    // Another load may have cached the same file since this one began, keep the cached one
+    for (size_t i = 0; i < load.mTextures.size(); i++) {
+        Texture *tex = load.mTextures[i];
+        auto iter = mTextures.find(load.mTexturePaths[i]);
+        if (iter != mTextures.end()) {
+            if (tex) {
+                tex->Unload();
+                delete tex;
+            }
+            tex = iter->second;
+        } else if (load.mTextureLoaded[i]) {
+            UploadTexture(tex);
+            mTextures.emplace(load.mTexturePaths[i], tex);
+        } else {
+            delete tex;
+            continue;
+        }
+        if (i < load.mRequestedTextures) {
+            mPinnedTextures.emplace(tex);
+        }
+    }
+    for (size_t i = 0; i < load.mMeshes.size(); i++) {
+        if (load.mMeshLoaded[i] && mMeshes.find(load.mMeshPaths[i]) == mMeshes.end()) {
+            load.mMeshes[i]->Upload(this);
+            mMeshes.emplace(load.mMeshPaths[i], load.mMeshes[i]);
+        } else {
+            delete load.mMeshes[i];
+        }
+    }
+    SDL_Log("Loaded %zu meshes and %zu textures", load.mMeshes.size(), load.mTextures.size());
+    load = AssetLoad();
+}
+
+void Renderer::PreloadAssets(const std::vector<std::string> &meshNames, const std::vector<std::string> &textureNames,
+                             JobSystem &jobSystem) {
+    PROFILE_SCOPE("Renderer::PreloadAssets");
+    AssetLoad load;
+    BeginAssetLoad(load, meshNames, textureNames);
+    DecodeAssets(load, jobSystem);
+    FinishAssetLoad(load);
+}
+
+bool Renderer::LoadAtlas(const std::string &fileName) {
+    PROFILE_SCOPE("Renderer::LoadAtlas");
+    std::ifstream file(Game::PROJECT_BASE + fileName);
+    if (!file.is_open()) {
+        SDL_Log("File not found: Atlas %s", fileName.c_str());
+        return false;
+    }
+    std::stringstream fileStream;
+    fileStream << file.rdbuf();
+    std::string contents = fileStream.str();
+    rapidjson::StringStream jsonStr(contents.c_str());
+    rapidjson::Document doc;
+    doc.ParseStream(jsonStr);
+    if (!doc.IsObject() || !doc.HasMember("textures") || !doc["textures"].IsArray()) {
+        SDL_Log("Atlas %s is not valid json", fileName.c_str());
+        return false;
+    }
+    if (!doc.HasMember("version") || !doc["version"].IsInt() || doc["version"].GetInt() != 1) {
+        SDL_Log("Atlas %s not version 1", fileName.c_str());
+        return false;
+    }
+    int maxSize = doc.HasMember("maxSize") && doc["maxSize"].IsInt() ? doc["maxSize"].GetInt() : 2048;
+    int padding = doc.HasMember("padding") && doc["padding"].IsInt() ? doc["padding"].GetInt() : 2;
+
+    // Images already loaded on their own stay that way, pointers to them are out there
+    std::vector<std::string> paths;
+    const rapidjson::Value &textures = doc["textures"];
+    for (rapidjson::SizeType i = 0; i < textures.Size(); i++) {
+        if (!textures[i].IsString()) {
+            SDL_Log("Atlas %s has a texture entry that isn't a file name", fileName.c_str());
+            continue;
+        }
+        std::string filePath = Game::PROJECT_BASE + textures[i].GetString();
+        if (mTextures.count(filePath)) {
+            SDL_Log("%s is already loaded, left out of atlas %s", textures[i].GetString(), fileName.c_str());
+        } else {
+            paths.emplace_back(filePath);
+        }
+    }
+    std::vector<Texture> images(paths.size());
+    std::vector<uint8_t> loaded(paths.size());
+    mGame->GetJobSystem().ParallelFor(static_cast<uint32_t>(paths.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            loaded[i] = DecodeTexture(&images[i], paths[i]);
+        }
+    });
+
+    std::vector<RectPacker::Rect> rects;
+    std::vector<size_t> imageOf;  // rect index -> image index
+    for (size_t i = 0; i < images.size(); i++) {
+        if (loaded[i]) {
+            rects.push_back({images[i].GetWidth(), images[i].GetHeight()});
+            imageOf.emplace_back(i);
+        }
+    }
+
+    // Smallest power of two that fits, growing width and height in turn
+    int width = MIN_ATLAS_SIZE;
+    int height = MIN_ATLAS_SIZE;
+    while (!RectPacker::Pack(rects, width, height, padding)) {
+        if (width > height) {
+            height *= 2;
+        } else {
+            width *= 2;
+        }
+        if (width > maxSize || height > maxSize) {
+            SDL_Log("Atlas %s doesn't fit in %dx%d", fileName.c_str(), maxSize, maxSize);
+            for (auto &image : images) {
+                image.Unload();
+            }
+            return false;
+        }
+    }
+
+    // Copy the images in, rows are already bottom first. Missing channels become gray/opaque
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4, 0);
+    for (size_t r = 0; r < rects.size(); r++) {
+        const Texture &image = images[imageOf[r]];
+        const unsigned char *src = image.GetPixels();
+        if (!src) {
+            continue;  // headless, dimensions only
+        }
+        int channels = image.GetChannels();
+        for (int y = 0; y < rects[r].mHeight; y++) {
+            for (int x = 0; x < rects[r].mWidth; x++) {
+                const unsigned char *in = src + (static_cast<size_t>(y) * rects[r].mWidth + x) * channels;
+                unsigned char *out = pixels.data() + ((static_cast<size_t>(rects[r].mY) + y) * width + rects[r].mX + x) * 4;
+                out[0] = in[0];
+                out[1] = channels >= 3 ? in[1] : in[0];
+                out[2] = channels >= 3 ? in[2] : in[0];
+                out[3] = channels == 4 ? in[3] : channels == 2 ? in[1] : 255;
+            }
+        }
+    }
+    Texture *atlas = CreateTextureFromPixels(pixels.data(), width, height);
+    mAtlases.emplace_back(atlas);
+
+    // Regions go in the cache under the image name, pinned like any texture from GetTexture
+    for (size_t r = 0; r < rects.size(); r++) {
+        auto *region = new Texture();
+        region->SetAtlasRegion(*atlas, rects[r].mX, rects[r].mY, rects[r].mWidth, rects[r].mHeight);
+        mTextures.emplace(paths[imageOf[r]], region);
+        mPinnedTextures.emplace(region);
+    }
+    for (auto &image : images) {
+        image.Unload();
+    }
+    SDL_Log("Packed %zu images into %dx%d atlas %s", rects.size(), width, height, fileName.c_str());
+    return true;
+}
+
+void Renderer::ReloadAsset(const std::string &fileName) {
+    std::string filePath = Game::PROJECT_BASE + fileName;
+    std::string extension = fileName.substr(fileName.find_last_of('.') + 1);
+
+    if (extension == "vert" || extension == "frag") {
+        // Shader name is the file name without folder and extension
+        size_t nameStart = fileName.find_last_of('/') + 1;
+        std::string name = fileName.substr(nameStart, fileName.find_last_of('.') - nameStart);
+        bool loaded = mNameToShader.count(name) || (mSpriteShader && name == "Sprite");
+        if (loaded && std::find(mShaderReloads.begin(), mShaderReloads.end(), name) == mShaderReloads.end()) {
+            mShaderReloads.emplace_back(name);
+        }
+        return;
+    }
+
+    auto reload = std::make_unique<PendingReload>();
+    reload->mFilePath = filePath;
+    PendingReload *pending = reload.get();
+    if (extension == "gpmesh" && mMeshes.count(filePath)) {
+        reload->mMesh = new Mesh();
+        mGame->GetJobSystem().SubmitBackground([pending]() {
+            pending->mLoaded = pending->mMesh->Parse(pending->mFilePath);
+        }, &reload->mJob);
+    } else if (mTextures.count(filePath)) {
+        reload->mTexture = new Texture();
+        mGame->GetJobSystem().SubmitBackground([this, pending]() {
+            pending->mLoaded = DecodeTexture(pending->mTexture, pending->mFilePath);
+        }, &reload->mJob);
+    } else {
+        return;  // not loaded, nothing to refresh
+    }
+    SDL_Log("Reloading %s", fileName.c_str());
+    mPendingReloads.emplace_back(std::move(reload));
+}
+
+void Renderer::ApplyReloads() {
+    if (mPendingReloads.empty() && mShaderReloads.empty()) {
+        return;
+    }
+    PROFILE_SCOPE("Renderer::ApplyReloads");
+
+    // Swap contents with the cached object, old GL objects end up in the fresh one and are deleted with it.
+    // Bounds of collision boxes made from a mesh keep their old value
+    for (auto iter = mPendingReloads.begin(); iter != mPendingReloads.end();) {
+        PendingReload &reload = **iter;
+        if (!reload.mJob.IsDone()) {
+            ++iter;
+            continue;
+        }
+
+        // Streaming may have unloaded the asset while the job ran
+        auto texIter = mTextures.find(reload.mFilePath);
+        auto meshIter = mMeshes.find(reload.mFilePath);
+        bool cached = reload.mTexture ? texIter != mTextures.end() : meshIter != mMeshes.end();
+
+        if (!reload.mLoaded || !cached) {
+            if (!reload.mLoaded) {
+                SDL_Log("Reload of %s failed, keeping the old one", reload.mFilePath.c_str());
+            }
+            if (reload.mTexture) {
+                reload.mTexture->Unload();
+            }
+            delete reload.mMesh;
+            delete reload.mTexture;
+        } else if (reload.mTexture) {
+            UploadTexture(reload.mTexture);
+            Texture *tex = texIter->second;
+            std::swap(*tex, *reload.mTexture);
+            reload.mTexture->Unload();
+            delete reload.mTexture;
+        } else {
+            reload.mMesh->Upload(this);
+            Mesh *mesh = meshIter->second;
+            // Shader groups are keyed by shader, move the components if the mesh changed shader
+            if (reload.mMesh->GetShaderName() != mesh->GetShaderName()) {
+                for (auto mc: mMeshComps) {
+                    if (mc->GetMesh() == mesh) {
+                        RemoveMeshGroupRenderer(mc, mesh->GetShaderName());
+                        AddMeshGroupRenderer(mc, reload.mMesh->GetShaderName());
+                    }
+                }
+            }
+            std::swap(*mesh, *reload.mMesh);
+            for (auto &batch: mStaticBatches) {
+                for (auto mc: batch->mComponents) {
+                    batch->mDirty = batch->mDirty || mc->GetMesh() == mesh;
+                }
+            }
+            reload.mMesh->Unload();
+            delete reload.mMesh;
+        }
+        iter = mPendingReloads.erase(iter);
+    }
+
+    for (const auto &name: mShaderReloads) {
+        Shader *shader = name == "Sprite" ? mSpriteShader : mNameToShader[name];
+        auto *fresh = new Shader();
+        if (fresh->Load("shaders/" + name + ".vert", "shaders/" + name + ".frag")) {
+            std::swap(*shader, *fresh);
+            SDL_Log("Reloaded shader %s", name.c_str());
+        } else {
+            SDL_Log("Reload of shader %s failed, keeping the old one", name.c_str());
+        }
+        fresh->Unload();
+        delete fresh;
+    }
+    mShaderReloads.clear();
+}
+
+void Renderer::WaitPendingReloads() {
+    for (auto &reload: mPendingReloads) {
+        mGame->GetJobSystem().Wait(reload->mJob);
+        if (reload->mTexture) {
+            reload->mTexture->Unload();  // decoded pixels
+        }
+        delete reload->mMesh;
+        delete reload->mTexture;
+    }
+    mPendingReloads.clear();
+}
+
+Texture *Renderer::CreateTexture(const std::string &filePath) {
+    auto *tex = new Texture();
+    if (!DecodeTexture(tex, filePath)) {
+        delete tex;
+        return nullptr;
+    }
+    UploadTexture(tex);
+    return tex;
+}
+
+bool Renderer::DecodeTexture(Texture *tex, const std::string &filePath) {
+    return tex->Decode(filePath);
+}
+
+void Renderer::UploadTexture(Texture *tex) {
+    tex->Upload();
+}
+
+Texture *Renderer::CreateTextureFromPixels(const unsigned char *pixels, int width, int height) {
+    auto *tex = new Texture();
+    tex->CreateFromPixels(pixels, width, height);
+    return tex;
+}
+
+Texture *Renderer::CreateTextureFromSurface(SDL_Surface *surface) {
+    auto *tex = new Texture();
+    tex->CreateFromSurface(surface);
+    return tex;
+}
+
+VertexArray *Renderer::CreateVertexArray(const float *verts, unsigned int numVerts,
+                                         const unsigned int *indices, unsigned int numIndices) {
+    return new VertexArray(verts, numVerts, indices, numIndices);
+}
+
 bool Renderer::LoadShaders() {
     // Create sprite shader
     mSpriteShader = new Shader();
@@ -236,11 +715,6 @@ bool Renderer::LoadShaders() {
         return false;
     }
 
-    mSpriteShader->SetActive();
-    // Set the view-projection matrix
-    Matrix4 viewProj = Matrix4::CreateSimpleViewProj(mScreenWidth, mScreenHeight);
-    mSpriteShader->SetMatrixUniform("uViewProj", viewProj);
-
 
     // Create default mesh shader
     mMeshShader = new Shader();
@@ -249,77 +723,199 @@ bool Renderer::LoadShaders() {
     }
     mNameToShader[mDefaultShaderName] = mMeshShader;
 
-    mMeshShader->SetActive();
-    // Set the view-projection matrix
+    // Set the view-projection matrix, shaders read it from the frame uniform buffer
     mView = Matrix4::CreateLookAt(Vector3::Zero, Vector3::UnitX, Vector3::UnitZ);
+    mDrawView = mView;
     mProjection = Matrix4::CreatePerspectiveFOV(Math::ToRadians(70.0f),
-                                                mScreenWidth, mScreenHeight, 25.0f, 10000.0f);
-    mMeshShader->SetMatrixUniform("uViewProj", mView * mProjection);
+                                                mScreenWidth, mScreenHeight, 25.0f, FAR_PLANE);
+    mFrameUniformBuffer = new UniformBuffer(mFrameData, Shader::FRAME_BLOCK_BINDING);
     return true;
 }
 
-void Renderer::CreateSpriteVerts() {
-    // most image file formats store their data starting at the top left row
-    // Opengl starts from bottom left, we follow because we inverse when loading with std_image
-    float vertices[] = {
-            -0.5f, 0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, // top left
-            0.5f, 0.5f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, // top right
-            0.5f, -0.5f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, // bottom right
-            -0.5f, -0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f  // bottom left
-    };
+void Renderer::UpdateFrameUniforms() {
+    FrameUniforms uniforms{};
+    uniforms.mViewProj = mDrawView * mProjection;
+    uniforms.mSpriteViewProj = Matrix4::CreateSimpleViewProj(mScreenWidth, mScreenHeight);
+    // Camera position is from inverted view
+    Matrix4 invView = mDrawView;
+    invView.Invert();
+    mCameraPos = invView.GetTranslation();
+    uniforms.mCameraPos = mCameraPos;
+    uniforms.mAmbientLight = mAmbientLight;
+    uniforms.mDirLightDirection = mDirLight.mDirection;
+    uniforms.mDirLightDiffuseColor = mDirLight.mDiffuseColor;
+    uniforms.mDirLightSpecColor = mDirLight.mSpecColor;
+    mFrameUniformBuffer->Update(&uniforms, sizeof(uniforms));
+}
+
+void Renderer::DrawMeshes(float alpha) {
+    PROFILE_SCOPE("Renderer::DrawMeshes");
+    UpdateStaticBatches();
+
+    // Visible components and static batches with bounding spheres, then drop the ones outside the view 4 at a time
+    mMeshInstances.clear();
+    mCullSpheres.clear();
+    for (const auto &shaderGroup : mShaderGroup) {
+        for (auto mc : shaderGroup.second) {
+            if (!mc->GetVisible() || !mc->GetMesh()) {
+                continue;
+            }
+            Mesh *mesh = mc->GetMesh();
+            MeshInstance instance{shaderGroup.first, mesh->GetVertexArray(), mc->GetTexture(), mesh->GetSpecPower(),
+                                  &mesh->GetBox(), mc->GetOwner()->GetInterpolatedTransform(alpha)};
+            Vector3 scale = instance.mWorldTransform.GetScale();
+            mCullSpheres.emplace_back(instance.mWorldTransform.GetTranslation(),
+                                      mesh->GetRadius() * std::max({scale.x, scale.y, scale.z}));
+            mMeshInstances.emplace_back(instance);
+        }
+    }
+    for (const auto &batch : mStaticBatches) {
+        mMeshInstances.push_back({batch->mShader, batch->mVertexArray, batch->mTexture, batch->mSpecPower,
+                                  &batch->mBox, Matrix4::Identity});
+        Vector3 center = (batch->mBox.mMin + batch->mBox.mMax) * 0.5f;
+        mCullSpheres.emplace_back(center, (batch->mBox.mMax - center).Length());
+    }
+    Frustum frustum(mDrawView * mProjection);
+    mCullResults.resize(mCullSpheres.size());
+    Intersect(frustum, mCullSpheres.data(), mCullSpheres.size(), mCullResults.data());
+
+    // Queue what is left once per pass, keys put equal state together and near draws first
+    mRenderQueue.Clear();
+    for (uint32_t i = 0; i < mMeshInstances.size(); i++) {
+        if (!mCullResults[i]) {
+            continue;
+        }
+        const MeshInstance &instance = mMeshInstances[i];
+        // Spheres are loose around long thin meshes like walls, boxes are tighter
+        AABB box = *instance.mBox;
+        box.Transform(instance.mWorldTransform);
+        if (!Intersect(frustum, box)) {
+            continue;
+        }
+
+        float depth = (mCullSpheres[i].mCenter - mCameraPos).Length() / FAR_PLANE;
+        uint32_t shaderId = GetSortId(instance.mShader);
+        uint32_t vertexArrayId = GetSortId(instance.mVertexArray);
+        if (mDepthPrepass) {
+            // Texture doesn't matter without color writes
+            mRenderQueue.Push(RenderQueue::MakeKey(RenderQueue::EDepthPrepass, shaderId, 0, vertexArrayId, depth), i);
+        }
+        mRenderQueue.Push(RenderQueue::MakeKey(RenderQueue::EOpaque, shaderId, GetSortId(instance.mTexture),
+                                               vertexArrayId, depth), i);
+    }
+    if (mRenderQueue.GetItems().empty()) {
+        return;
+    }
+    mRenderQueue.Sort();
+    const auto &items = mRenderQueue.GetItems();
 
-    unsigned int indices[] = {
-            0, 1, 2,
-            2, 3, 0
-    };
+    // Every transform written once into mapped memory, each batch then points its vertex array at its own range
+    size_t instanceOffset = 0;
+    auto *transforms = static_cast<Matrix4 *>(mFrameData->Map(items.size() * sizeof(Matrix4), sizeof(float) * 4,
+                                                              instanceOffset));
+    for (size_t i = 0; i < items.size(); i++) {
+        transforms[i] = mMeshInstances[items[i].mIndex].mWorldTransform;
+    }
+    mFrameData->Unmap();
+    unsigned int instanceBuffer = mFrameData->GetBuffer();
 
-    mSpriteVerts = new VertexArray(vertices, 4, indices, 6);
+    if (mDepthPrepass) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    }
+    RenderQueue::Pass curPass = RenderQueue::GetPass(items.front().mKey);
+    Shader *curShader = nullptr;
+    float curSpecPower = -1.0f;
+    Texture *curTexture = nullptr;
+    for (size_t first = 0; first < items.size();) {
+        RenderQueue::Pass pass = RenderQueue::GetPass(items[first].mKey);
+        const MeshInstance &batch = mMeshInstances[items[first].mIndex];
+        size_t last = first + 1;
+        while (last < items.size()) {
+            const MeshInstance &next = mMeshInstances[items[last].mIndex];
+            if (RenderQueue::GetPass(items[last].mKey) != pass || next.mShader != batch.mShader ||
+                next.mVertexArray != batch.mVertexArray || (pass == RenderQueue::EOpaque && next.mTexture != batch.mTexture)) {
+                break;
+            }
+            last++;
+        }
+
+        if (pass != curPass) {
+            // Depth is complete, shade only the visible surface
+            curPass = pass;
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthMask(GL_FALSE);
+            glDepthFunc(GL_LEQUAL);
+        }
+        if (batch.mShader != curShader) {
+            curShader = batch.mShader;
+            curShader->SetActive();
+            curSpecPower = -1.0f;  // uniforms belong to the program
+        }
+        if (pass == RenderQueue::EOpaque) {
+            if (batch.mSpecPower != curSpecPower) {
+                curSpecPower = batch.mSpecPower;
+                curShader->SetFloatUniform("uSpecPower", curSpecPower);
+            }
+            if (batch.mTexture && batch.mTexture != curTexture) {
+                curTexture = batch.mTexture;
+                curTexture->SetActive();
+            }
+        }
+        VertexArray *va = batch.mVertexArray;
+        va->SetInstanceBuffer(instanceBuffer, instanceOffset + first * sizeof(Matrix4));
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(va->GetNumIndices()), GL_UNSIGNED_INT, nullptr,
+                                static_cast<GLsizei>(last - first));
+        first = last;
+    }
+
+    if (mDepthPrepass) {
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
+    }
 }
 
-void Renderer::SetLightUniforms(Shader* shader) {
-    // Camera position is from inverted view
-    Matrix4 invView = mView;
-    invView.Invert();
-    shader->SetVectorUniform("uCameraPos", invView.GetTranslation());
-    // Ambient light
-    shader->SetVectorUniform("uAmbientLight", mAmbientLight);
-    // Directional light, notice we use dot notation to access struct
-    shader->SetVectorUniform("uDirLight.mDirection", mDirLight.mDirection);
-    shader->SetVectorUniform("uDirLight.mDiffuseColor",mDirLight.mDiffuseColor);
-    shader->SetVectorUniform("uDirLight.mSpecColor", mDirLight.mSpecColor);
+uint32_t Renderer::GetSortId(const void *object) {
+    auto iter = mSortIds.find(object);
+    if (iter == mSortIds.end()) {
+        iter = mSortIds.emplace(object, mNextSortId++).first;
+    }
+    return iter->second;
 }
 
 void Renderer::AddMeshGroupRenderer(MeshComponent *mesh, const std::string &shaderName) {
     // 1. find if the shader path exist
-    auto shader = mNameToShader.find(shaderName);
-    if (shader != mNameToShader.end()) {  // shader exist, add to existing group
-        mShaderGroup[shader->second].push_back(mesh);
-        return;
-    }
-
-    // 2. We don't have that shader in cache, try to create one
-    auto newShader = new Shader();
-    if (!newShader->Load("shaders/" + shaderName + ".vert", "shaders/" + shaderName + ".frag")) {
-        // 3. Doesn't exist, use default
-        delete newShader;
-        mShaderGroup[mMeshShader].push_back(mesh);
+    Shader *shader = nullptr;
+    auto iter = mNameToShader.find(shaderName);
+    if (iter != mNameToShader.end()) {  // shader exist, add to existing group
+        shader = iter->second;
+    } else {
+        // 2. We don't have that shader in cache, try to create one
+        auto newShader = new Shader();
+        if (!newShader->Load("shaders/" + shaderName + ".vert", "shaders/" + shaderName + ".frag")) {
+            // 3. Doesn't exist, use default
+            delete newShader;
+            shader = mMeshShader;
+        } else {
+            // 4. Exist a shader file, store it. View-projection and lights come from the frame uniform buffer
+            mNameToShader[shaderName] = newShader;
+            shader = newShader;
+        }
     }
-    else {
-        // 4. Exist a shader file, store it and do initial setting
-        mNameToShader[shaderName] = newShader;
-        mShaderGroup[newShader].push_back(mesh);
 
-        // Same code as default shader setup
-        newShader->SetActive();
-        // Set the view-projection matrix
-        mView = Matrix4::CreateLookAt(Vector3::Zero, Vector3::UnitX, Vector3::UnitZ);
-        mProjection = Matrix4::CreatePerspectiveFOV(Math::ToRadians(70.0f),
-                                                    mScreenWidth, mScreenHeight, 25.0f, 10000.0f);
-        newShader->SetMatrixUniform("uViewProj", mView * mProjection);
+    // Static meshes go into a batch at next draw, the others are instanced every frame
+    if (mesh->IsStatic()) {
+        mPendingStatic.emplace_back(mesh, shader);
+    } else {
+        mShaderGroup[shader].push_back(mesh);
     }
 }
 
 void Renderer::RemoveMeshGroupRenderer(MeshComponent *mesh, const std::string &shaderName) {
+    if (mesh->IsStatic()) {
+        RemoveStaticMesh(mesh);
+        return;
+    }
+
     // remove mesh renderer from group, ugly C++
     auto shader = mNameToShader.find(shaderName);
     if (shader == mNameToShader.end()) {
@@ -333,6 +929,102 @@ void Renderer::RemoveMeshGroupRenderer(MeshComponent *mesh, const std::string &s
             );
 }
 
+void Renderer::RemoveStaticMesh(MeshComponent *mesh) {
+    auto iter = mStaticBatchOf.find(mesh);
+    if (iter == mStaticBatchOf.end()) {
+        mPendingStatic.erase(std::remove_if(mPendingStatic.begin(), mPendingStatic.end(),
+                                            [mesh](const std::pair<MeshComponent *, Shader *> &pending) {
+                                                return pending.first == mesh;
+                                            }), mPendingStatic.end());
+        return;
+    }
+    // Rebuilt (or dropped if empty) at next draw
+    StaticBatch *batch = iter->second;
+    batch->mComponents.erase(std::remove(batch->mComponents.begin(), batch->mComponents.end(), mesh),
+                             batch->mComponents.end());
+    batch->mDirty = true;
+    mStaticBatchOf.erase(iter);
+}
+
+void Renderer::UpdateStaticBatches() {
+    for (const auto &pending: mPendingStatic) {
+        MeshComponent *mc = pending.first;
+        Actor *owner = mc->GetOwner();
+        owner->ComputeWorldTransform();
+        Vector3 position = owner->GetWorldPosition();
+        int x = static_cast<int>(std::floor(position.x / STATIC_BATCH_CELL_SIZE));
+        int y = static_cast<int>(std::floor(position.y / STATIC_BATCH_CELL_SIZE));
+        Texture *texture = mc->GetTexture();
+        float specPower = mc->GetMesh()->GetSpecPower();
+
+        auto iter = std::find_if(mStaticBatches.begin(), mStaticBatches.end(),
+                                 [&](const std::unique_ptr<StaticBatch> &batch) {
+                                     return batch->mShader == pending.second && batch->mTexture == texture &&
+                                            batch->mSpecPower == specPower && batch->mX == x && batch->mY == y;
+                                 });
+        if (iter == mStaticBatches.end()) {
+            auto batch = std::make_unique<StaticBatch>();
+            batch->mShader = pending.second;
+            batch->mTexture = texture;
+            batch->mSpecPower = specPower;
+            batch->mX = x;
+            batch->mY = y;
+            mStaticBatches.emplace_back(std::move(batch));
+            iter = mStaticBatches.end() - 1;
+        }
+        (*iter)->mComponents.emplace_back(mc);
+        (*iter)->mDirty = true;
+        mStaticBatchOf[mc] = iter->get();
+    }
+    mPendingStatic.clear();
+
+    for (auto iter = mStaticBatches.begin(); iter != mStaticBatches.end();) {
+        StaticBatch &batch = **iter;
+        if (batch.mComponents.empty()) {
+            mSortIds.erase(batch.mVertexArray);
+            iter = mStaticBatches.erase(iter);
+            continue;
+        }
+        if (batch.mDirty) {
+            BuildStaticBatch(batch);
+        }
+        ++iter;
+    }
+}
+
+void Renderer::BuildStaticBatch(StaticBatch &batch) {
+    PROFILE_SCOPE("Renderer::BuildStaticBatch");
+    // Every mesh moved to world space, indices offset past the vertices before it
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    batch.mBox = AABB(Vector3::Infinity, Vector3::NegInfinity);
+    for (auto mc: batch.mComponents) {
+        Mesh *mesh = mc->GetMesh();
+        mc->GetOwner()->ComputeWorldTransform();
+        Matrix4 world = mc->GetOwner()->GetWorldTransform();
+        auto base = static_cast<unsigned int>(vertices.size() / Mesh::VERTEX_SIZE);
+
+        const std::vector<float> &src = mesh->GetVertices();
+        for (size_t i = 0; i + Mesh::VERTEX_SIZE <= src.size(); i += Mesh::VERTEX_SIZE) {
+            Vector3 position = Vector3::Transform(Vector3(src[i], src[i + 1], src[i + 2]), world);
+            Vector3 normal = Vector3::Transform(Vector3(src[i + 3], src[i + 4], src[i + 5]), world, 0.0f);
+            normal.Normalize();
+            batch.mBox.UpdateMinMax(position);
+            vertices.insert(vertices.end(), {position.x, position.y, position.z,
+                                             normal.x, normal.y, normal.z, src[i + 6], src[i + 7]});
+        }
+        for (auto index: mesh->GetIndices()) {
+            indices.emplace_back(base + index);
+        }
+    }
+
+    mSortIds.erase(batch.mVertexArray);
+    delete batch.mVertexArray;
+    batch.mVertexArray = CreateVertexArray(vertices.data(), static_cast<unsigned int>(vertices.size() / Mesh::VERTEX_SIZE),
+                                           indices.data(), static_cast<unsigned int>(indices.size()));
+    batch.mDirty = false;
+}
+
 Vector3 Renderer::Unproject(const Vector3 &screenPoint) const {
     // Convert screenPoint to device coordinates (between -1 and +1)
     Vector3 deviceCoord = screenPoint;
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <SDL_render.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "../helper/Math.hpp"
+#include "../helper/Collision.hpp"
+#include "RenderQueue.hpp"
 
 struct DirectionalLight {
     Vector3 mDirection; // Direction of light
@@ -12,16 +16,30 @@ struct DirectionalLight {
     Vector3 mSpecColor; // Specular color
 };
 
+// Meshes and textures on their way into the renderer cache, see Renderer::BeginAssetLoad
+struct AssetLoad {
+    std::vector<std::string> mMeshPaths;
+    std::vector<class Mesh*> mMeshes;
+    std::vector<uint8_t> mMeshLoaded;
+    // Textures asked for directly first, then the ones used by the meshes
+    std::vector<std::string> mTexturePaths;
+    std::vector<class Texture*> mTextures;
+    std::vector<uint8_t> mTextureLoaded;
+    size_t mRequestedTextures = 0;
+    std::unordered_set<std::string> mCachedTextures;  // cache when the load began, not decoded again
+};
+
 class Renderer {
 public:
     explicit Renderer(class Game* game);
-    ~Renderer();
+    virtual ~Renderer();
 
     // Main function called by Game
-    bool Initialize(float screenWidth, float screenHeight);
-    void Shutdown();
+    virtual bool Initialize(float screenWidth, float screenHeight);
+    virtual void Shutdown();
     void UnloadData();
-    void Draw();
+    // Alpha is how far we are between the last two simulation steps
+    virtual void Draw(float alpha);
 
     void AddSprite(class SpriteComponent* sprite);
     void RemoveSprite(class SpriteComponent* sprite);
@@ -30,14 +48,58 @@ public:
     void RemoveMeshComp(class MeshComponent* mesh);
 
     // Mesh group renderer to support multiple shaders with different meshes
-    void AddMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName);
-    void RemoveMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName);
+    virtual void AddMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName);
+    virtual void RemoveMeshGroupRenderer(class MeshComponent* mesh, const std::string &shaderName);
 
+    // Textures from GetTexture stay loaded until UnloadData
     class Texture* GetTexture(const std::string& fileName);
     class Mesh* GetMesh(const std::string& fileName);
+    // Same cache as GetTexture, but the texture goes away with the last mesh using it (UnloadMesh)
+    class Texture* GetMeshTexture(const std::string& fileName);
+    // Free a mesh and the textures only it used, kept if a mesh component still draws it
+    void UnloadMesh(const std::string& fileName);
+
+    // Load every mesh (and their textures) and texture not cached yet in three steps, so the slow part
+    // can run in the background. Begin and finish run on this thread, decode on any thread
+    // (files are parsed/decoded on the job system). Finish uploads to the GPU and fills the cache
+    void BeginAssetLoad(AssetLoad& load, const std::vector<std::string>& meshNames,
+                        const std::vector<std::string>& textureNames) const;
+    void DecodeAssets(AssetLoad& load, class JobSystem& jobSystem);
+    void FinishAssetLoad(AssetLoad& load);
+    // All three steps, GetMesh/GetTexture then hit the cache
+    void PreloadAssets(const std::vector<std::string>& meshNames, const std::vector<std::string>& textureNames,
+                       class JobSystem& jobSystem);
+
+    class Texture* CreateTexture(const std::string& filePath);
+    // Texture creation in two steps, decode is called from worker threads (return false on failure)
+    virtual bool DecodeTexture(class Texture* tex, const std::string& filePath);
+    virtual void UploadTexture(class Texture* tex);
+
+    // Pack the images listed in an atlas manifest (.gpatlas) into one texture, images are decoded on the
+    // job system. GetTexture then returns regions of it, so sprites and UI using them share one bound texture.
+    // Only for sprite/UI images, mesh texture coords aren't remapped
+    bool LoadAtlas(const std::string& fileName);
+
+    // Hot reload a changed file (relative to project base) if it is loaded. Meshes and textures are parsed on
+    // the job system, shaders recompile on this thread. Objects are swapped in place by ApplyReloads,
+    // so pointers held by components stay valid
+    void ReloadAsset(const std::string& fileName);
+    // Call at a frame boundary
+    void ApplyReloads();
+
+    // GPU resource creation, overridden by headless renderer (return nullptr on failure)
+    virtual class Texture* CreateTextureFromSurface(struct SDL_Surface* surface);
+    virtual class Texture* CreateTextureFromPixels(const unsigned char* pixels, int width, int height);
+    virtual class VertexArray* CreateVertexArray(const float* verts, unsigned int numVerts,
+                                                 const unsigned int* indices, unsigned int numIndices);
+
+    // Draw opaque meshes twice, depth only then shading, so each pixel is shaded once
+    void SetDepthPrepass(bool value) { mDepthPrepass = value; }
 
     // 3D render related
-    void SetViewMatrix(const Matrix4& view) { mView = view; }
+    void SetViewMatrix(const Matrix4& view) { mView = view; mDrawView = view; }
+    // View used for drawing only, between two steps. Unproject keeps the simulation view
+    void SetDrawViewMatrix(const Matrix4& view) { mDrawView = view; }
     void SetAmbientLight(const Vector3& ambient) { mAmbientLight = ambient; }
     DirectionalLight& GetDirectionalLight() { return mDirLight; }
 
@@ -52,15 +114,28 @@ public:
     [[nodiscard]] Vector3 Unproject(const Vector3& screenPoint) const;
     void GetScreenDirection(Vector3& outStart, Vector3& outDir) const;
 
-private:
+protected:
     // responsible for Opengl shader
     bool LoadShaders();
-    void CreateSpriteVerts();
-    void SetLightUniforms(class Shader* shader);
+    // Fill the frame uniform buffer, once per frame before drawing
+    void UpdateFrameUniforms();
+    // Draw mesh components in the view frustum in render queue order, one instanced draw per shader/mesh/texture
+    void DrawMeshes(float alpha);
+    // Small number standing for a shader, texture or mesh in sort keys
+    uint32_t GetSortId(const void* object);
 
     // Map of textures & meshes loaded
     std::unordered_map<std::string, class Texture*> mTextures;
     std::unordered_map<std::string, class Mesh*> mMeshes;
+    std::unordered_set<class Texture*> mPinnedTextures;  // handed out by GetTexture, never unloaded with a mesh
+    std::vector<class Texture*> mAtlases;  // their regions are in mTextures
+    constexpr static int MIN_ATLAS_SIZE = 256;
+
+    // Hot reloads waiting for their parse job, defined in Renderer.cpp
+    struct PendingReload;
+    std::vector<std::unique_ptr<PendingReload>> mPendingReloads;
+    std::vector<std::string> mShaderReloads;  // shader names
+    void WaitPendingReloads();
 
     // All the sprite, meshes components to draw
     std::vector<class SpriteComponent*> mSprites;
@@ -69,18 +144,74 @@ private:
     // Shaders and group meshes
     std::unordered_map<std::string, class Shader*> mNameToShader;
     std::unordered_map<class Shader*, std::vector<class MeshComponent*>> mShaderGroup;
+
+    // Static mesh components merged into world space vertex arrays, one per shader, texture, specular power
+    // and grid cell so a change only rebuilds its part of the level. Defined in Renderer.cpp
+    struct StaticBatch;
+    std::vector<std::unique_ptr<StaticBatch>> mStaticBatches;
+    std::unordered_map<class MeshComponent*, StaticBatch*> mStaticBatchOf;
+    // Added since last draw, batched once their owner has its final position
+    std::vector<std::pair<class MeshComponent*, class Shader*>> mPendingStatic;
+    void RemoveStaticMesh(class MeshComponent* mesh);
+    // Sort pending components into batches, rebuild changed batches
+    void UpdateStaticBatches();
+    void BuildStaticBatch(StaticBatch& batch);
+    constexpr static float STATIC_BATCH_CELL_SIZE = 1000.0f;
     std::string mDefaultShaderName = "BasicMesh";
 
     // Mesh & sprites shader
     class Shader* mSpriteShader = nullptr;
     class Shader* mMeshShader = nullptr;
 
-    // vertex array for sprites
-    class VertexArray* mSpriteVerts = nullptr;
+    // Visible mesh components of a frame, drawn in the order of the render queue
+    // A static batch is one instance with an identity transform
+    struct MeshInstance {
+        class Shader* mShader;
+        class VertexArray* mVertexArray;
+        class Texture* mTexture;
+        float mSpecPower;
+        const AABB* mBox;  // before transform
+        Matrix4 mWorldTransform;
+    };
+    std::vector<MeshInstance> mMeshInstances;
+    // World bounding sphere of each instance and whether it touches the view frustum
+    std::vector<Sphere> mCullSpheres;
+    std::vector<uint8_t> mCullResults;
+    RenderQueue mRenderQueue;
+    std::unordered_map<const void*, uint32_t> mSortIds;
+    uint32_t mNextSortId = 0;
+    bool mDepthPrepass = false;
+    // Instance transforms, sprite vertices and frame uniforms, rewritten every frame
+    class RingBuffer* mFrameData = nullptr;
+    constexpr static size_t FRAME_DATA_SIZE = 1024 * 1024;  // per frame, grows when a frame needs more
+
+    // Quads of sprites and UI
+    class SpriteBatch* mSpriteBatch = nullptr;
+
+    // Mirror of the FrameData uniform block in the shaders, std140: vec3 padded to 16 bytes
+    struct FrameUniforms {
+        Matrix4 mViewProj;
+        Matrix4 mSpriteViewProj;
+        Vector3 mCameraPos;
+        float mPad0;
+        Vector3 mAmbientLight;
+        float mPad1;
+        Vector3 mDirLightDirection;
+        float mPad2;
+        Vector3 mDirLightDiffuseColor;
+        float mPad3;
+        Vector3 mDirLightSpecColor;
+        float mPad4;
+    };
+    static_assert(sizeof(FrameUniforms) == 208, "FrameUniforms must match the std140 FrameData block");
+    class UniformBuffer* mFrameUniformBuffer = nullptr;
 
     // View/projection for 3D shaders
     Matrix4 mView;
+    Matrix4 mDrawView;
     Matrix4 mProjection;
+    Vector3 mCameraPos{};
+    constexpr static float FAR_PLANE = 10000.0f;
 
     // Width/height of screen
     float mScreenWidth = 0;
@@ -28,6 +28,13 @@ bool Shader::Load(const std::string &vertName, const std::string &fragName) {
         return false;
     }
 
+    // Shared per frame block always comes from the same binding point
+    GLuint blockIndex = glGetUniformBlockIndex(mShaderProgram, FRAME_BLOCK_NAME);
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(mShaderProgram, blockIndex, FRAME_BLOCK_BINDING);
+    }
+    CacheUniformLocations();
+
     return true;
 }
 
@@ -43,23 +50,53 @@ void Shader::SetActive() const {
     glUseProgram(mShaderProgram);
 }
 
-void Shader::SetMatrixUniform(const char *name, const Matrix4 &matrix) {
-    // Find the uniform by this name, could improve by caching the loc id
-    GLuint loc = glGetUniformLocation(mShaderProgram, name);
+void Shader::SetMatrixUniform(const char *name, const Matrix4 &matrix) const {
     // Send the matrix data to the uniform, true for row vectors
-    glUniformMatrix4fv(loc, 1, GL_TRUE, matrix.GetAsFloatPtr());
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_TRUE, matrix.GetAsFloatPtr());
 }
 
-void Shader::SetVectorUniform(const char* name, const Vector3& vector) {
-    GLuint loc = glGetUniformLocation(mShaderProgram, name);
+void Shader::SetVectorUniform(const char* name, const Vector3& vector) const {
     // Send the vector data
-    glUniform3fv(loc, 1, vector.GetAsFloatPtr());
+    glUniform3fv(GetUniformLocation(name), 1, vector.GetAsFloatPtr());
 }
 
-void Shader::SetFloatUniform(const char* name, float value) {
-    GLuint loc = glGetUniformLocation(mShaderProgram, name);
+void Shader::SetFloatUniform(const char* name, float value) const {
     // Send the float data
-    glUniform1f(loc, value);
+    glUniform1f(GetUniformLocation(name), value);
+}
+
+GLint Shader::GetUniformLocation(const char *name) const {
+    for (const auto &uniform: mUniformLocations) {
+        if (uniform.first == name) {
+            return uniform.second;
+        }
+    }
+    return -1;
+}
+
+void Shader::CacheUniformLocations() {
+    mUniformLocations.clear();
+    GLint count = 0;
+    glGetProgramiv(mShaderProgram, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(mShaderProgram, static_cast<GLuint>(i), sizeof(name), &length, &size, &type, name);
+
+        // Members of uniform blocks have no location, they are set through the buffer
+        GLint loc = glGetUniformLocation(mShaderProgram, name);
+        if (loc < 0) {
+            continue;
+        }
+        // Arrays are reported as "name[0]", look them up by plain name
+        std::string uniformName(name, static_cast<size_t>(length));
+        if (size > 1 && uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformName.resize(uniformName.size() - 3);
+        }
+        mUniformLocations.emplace_back(uniformName, loc);
+    }
 }
 
 bool Shader::CompileShader(const std::string &fileName,
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
 #include "glad/glad.h"
 #include "../helper/Math.hpp"
 
@@ -16,11 +18,18 @@ public:
     // Set this as the active shader program
     void SetActive() const;
     // Sets a Matrix uniform
-    void SetMatrixUniform(const char* name, const Matrix4& matrix);
+    void SetMatrixUniform(const char* name, const Matrix4& matrix) const;
     // Sets a Vector3 uniform
-    void SetVectorUniform(const char* name, const Vector3& vector);
+    void SetVectorUniform(const char* name, const Vector3& vector) const;
     // Sets a float uniform
-    void SetFloatUniform(const char* name, float value);
+    void SetFloatUniform(const char* name, float value) const;
+
+    // Location found at link time, -1 (ignored by glUniform) if the program has no such uniform
+    [[nodiscard]] GLint GetUniformLocation(const char* name) const;
+
+    // Uniform block with per frame data (camera, lights) shared by every shader, see Renderer::FrameUniforms
+    constexpr static const char* FRAME_BLOCK_NAME = "FrameData";
+    constexpr static GLuint FRAME_BLOCK_BINDING = 0;
 
 private:
     // Helper function used by Load
@@ -32,12 +41,16 @@ private:
     static bool IsCompiled(GLuint shader);
     // Tests whether vertex/fragment programs link
     bool IsValidProgram();
+    // Query every active uniform once after linking
+    void CacheUniformLocations();
 
 private:
     // Store the shader object IDs
-    GLuint mVertexShader;
-    GLuint mFragShader;
-    GLuint mShaderProgram;
+    GLuint mVertexShader = 0;
+    GLuint mFragShader = 0;
+    GLuint mShaderProgram = 0;
+    // Name -> location, a handful per shader so a linear scan beats hashing
+    std::vector<std::pair<std::string, GLint>> mUniformLocations;
 };
 
 
@@ -0,0 +1,177 @@
+#include "WorldStreamer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <SDL.h>
+#include "../Game.hpp"
+#include "../actors/Actor.hpp"
+#include "Renderer.hpp"
+#include "../helper/Profiler.hpp"
+
+WorldStreamer::WorldStreamer(Game *game) : mGame(game), mLoader(game) {}
+
+WorldStreamer::~WorldStreamer() {
+    Clear();
+}
+
+void WorldStreamer::SetLevel(LevelData level) {
+    Clear();
+    mActors = std::move(level.mActors);
+    mCellSize = level.mCellSize;
+    mLoadRadius = level.mLoadRadius;
+
+    // Bucket actors by the cell their position is in
+    std::unordered_map<uint64_t, Cell *> cellByCoord;
+    for (uint32_t i = 0; i < mActors.size(); i++) {
+        int x = static_cast<int>(std::floor(mActors[i].mPosition.x / mCellSize));
+        int y = static_cast<int>(std::floor(mActors[i].mPosition.y / mCellSize));
+        uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+
+        Cell *&cell = cellByCoord[key];
+        if (!cell) {
+            mCells.emplace_back(std::make_unique<Cell>());
+            cell = mCells.back().get();
+            cell->mX = x;
+            cell->mY = y;
+        }
+        cell->mActors.emplace_back(i);
+        mLoader.CollectMeshes(mActors[i], cell->mMeshes);
+    }
+
+    for (auto &cell: mCells) {
+        std::sort(cell->mMeshes.begin(), cell->mMeshes.end());
+        cell->mMeshes.erase(std::unique(cell->mMeshes.begin(), cell->mMeshes.end()), cell->mMeshes.end());
+    }
+    SDL_Log("World streamer split %zu actors into %zu cells", mActors.size(), mCells.size());
+}
+
+void WorldStreamer::Update(const Vector3 &center) {
+    Stream(center, mBlocking);
+}
+
+void WorldStreamer::LoadAround(const Vector3 &center) {
+    Stream(center, true);
+}
+
+void WorldStreamer::Clear() {
+    // Jobs write into the cells, they have to finish first
+    for (auto &cell: mCells) {
+        if (cell->mState == ELoadingAssets) {
+            mGame->GetJobSystem().Wait(cell->mAssetJob);
+            mGame->GetRenderer()->FinishAssetLoad(cell->mAssets);
+        }
+    }
+    mCells.clear();
+    mActors.clear();
+    mMeshRefs.clear();
+}
+
+size_t WorldStreamer::GetLoadedCellCount() const {
+    return std::count_if(mCells.begin(), mCells.end(),
+                         [](const std::unique_ptr<Cell> &cell) { return cell->mState == ELoaded; });
+}
+
+void WorldStreamer::Stream(const Vector3 &center, bool blocking) {
+    if (mCells.empty()) {
+        return;
+    }
+    PROFILE_SCOPE("WorldStreamer::Update");
+    Uint64 start = SDL_GetPerformanceCounter();
+    auto budget = static_cast<Uint64>(mFrameBudget / 1000.0f * static_cast<float>(SDL_GetPerformanceFrequency()));
+    auto hasBudget = [&]() { return blocking || SDL_GetPerformanceCounter() - start < budget; };
+
+    int centerX = static_cast<int>(std::floor(center.x / mCellSize));
+    int centerY = static_cast<int>(std::floor(center.y / mCellSize));
+
+    // Cells come in at load radius and go out one cell further, so walking along a border doesn't thrash
+    for (auto &cell: mCells) {
+        cell->mDistance = std::max(std::abs(cell->mX - centerX), std::abs(cell->mY - centerY));
+        bool wanted = cell->mDistance <= mLoadRadius;
+        bool unwanted = cell->mDistance > mLoadRadius + 1;
+        if (cell->mState == EUnloaded && wanted) {
+            StartAssetLoad(*cell);
+        } else if ((cell->mState == EInstantiating || cell->mState == ELoaded) && unwanted) {
+            cell->mState = EUnloading;
+        } else if (cell->mState == EUnloading && wanted) {
+            cell->mState = EInstantiating;  // pick up where deletion stopped
+        }
+    }
+
+    // Deletions first, memory goes down before it goes up
+    for (auto &cell: mCells) {
+        if (cell->mState != EUnloading) {
+            continue;
+        }
+        while (!cell->mSpawned.empty() && hasBudget()) {
+            // Gameplay may have deleted it already
+            if (Actor *actor = mGame->GetActor(cell->mSpawned.back())) {
+                delete actor;
+            }
+            cell->mSpawned.pop_back();
+        }
+        if (cell->mSpawned.empty()) {
+            cell->mState = EUnloaded;
+            ReleaseAssets(*cell);
+        }
+    }
+
+    // Nearest cells first
+    std::vector<Cell *> loading;
+    for (auto &cell: mCells) {
+        if (cell->mState == ELoadingAssets || cell->mState == EInstantiating) {
+            loading.emplace_back(cell.get());
+        }
+    }
+    std::sort(loading.begin(), loading.end(), [](const Cell *a, const Cell *b) { return a->mDistance < b->mDistance; });
+
+    for (auto cell: loading) {
+        if (cell->mState == ELoadingAssets) {
+            if (blocking) {
+                mGame->GetJobSystem().Wait(cell->mAssetJob);
+            }
+            if (!cell->mAssetJob.IsDone() || !hasBudget()) {
+                continue;
+            }
+            // GPU upload on this thread, then the cell's GetMesh calls hit the cache
+            mGame->GetRenderer()->FinishAssetLoad(cell->mAssets);
+            if (cell->mDistance > mLoadRadius + 1) {
+                cell->mState = EUnloaded;  // player left while decoding
+                ReleaseAssets(*cell);
+                continue;
+            }
+            cell->mState = EInstantiating;
+            mGame->ReserveActors(cell->mActors.size() - cell->mSpawned.size());
+        }
+
+        while (cell->mSpawned.size() < cell->mActors.size() && hasBudget()) {
+            Actor *actor = mLoader.CreateActor(mActors[cell->mActors[cell->mSpawned.size()]]);
+            cell->mSpawned.emplace_back(actor ? actor->GetHandle() : ActorHandle());
+        }
+        if (cell->mSpawned.size() == cell->mActors.size()) {
+            cell->mState = ELoaded;
+        }
+    }
+}
+
+void WorldStreamer::StartAssetLoad(Cell &cell) {
+    for (const auto &mesh: cell.mMeshes) {
+        mMeshRefs[mesh]++;
+    }
+
+    Renderer *renderer = mGame->GetRenderer();
+    renderer->BeginAssetLoad(cell.mAssets, cell.mMeshes, {});
+    AssetLoad *assets = &cell.mAssets;
+    JobSystem *jobSystem = &mGame->GetJobSystem();
+    jobSystem->SubmitBackground([renderer, assets, jobSystem]() { renderer->DecodeAssets(*assets, *jobSystem); },
+                                &cell.mAssetJob);
+    cell.mState = ELoadingAssets;
+}
+
+void WorldStreamer::ReleaseAssets(Cell &cell) {
+    for (const auto &mesh: cell.mMeshes) {
+        auto iter = mMeshRefs.find(mesh);
+        if (--iter->second == 0) {
+            mMeshRefs.erase(iter);
+            mGame->GetRenderer()->UnloadMesh(mesh);
+        }
+    }
+}
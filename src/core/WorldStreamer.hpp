@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LevelLoader.hpp"
+#include "JobSystem.hpp"
+#include "../actors/ActorRegistry.hpp"
+
+// Split a streamed level into square cells on the ground plane and keep only the cells around
+// the player loaded. Meshes/textures of a cell are parsed and decoded on the job system, then actors
+// are created and deleted within a time budget per update, so crossing a cell border doesn't stall a frame.
+// Streamed actors are recreated from level data, changes made to them are lost when their cell unloads
+class WorldStreamer {
+public:
+    explicit WorldStreamer(class Game* game);
+    ~WorldStreamer();
+
+    // Take the level actors, nothing is created until Update/LoadAround
+    void SetLevel(LevelData level);
+    // Move streaming forward around center, call once per simulation step
+    void Update(const Vector3& center);
+    // Load and unload everything around center right away (level start)
+    void LoadAround(const Vector3& center);
+    // Wait for background loads and forget the level, created actors are left to the game
+    void Clear();
+
+    // Time for creating/deleting actors per update
+    void SetFrameBudget(float milliseconds) { mFrameBudget = milliseconds; }
+    // Finish every load in the update that starts it, so record/replay sees the same actors every run
+    void SetBlocking(bool blocking) { mBlocking = blocking; }
+
+    [[nodiscard]] bool HasLevel() const { return !mCells.empty(); }
+    [[nodiscard]] size_t GetLoadedCellCount() const;
+
+private:
+    enum CellState {
+        EUnloaded,
+        ELoadingAssets,  // decode job running
+        EInstantiating,  // creating actors within the budget
+        ELoaded,
+        EUnloading  // deleting actors within the budget
+    };
+
+    struct Cell {
+        int mX = 0;
+        int mY = 0;
+        int mDistance = 0;  // to the center cell, in cells
+        CellState mState = EUnloaded;
+        std::vector<uint32_t> mActors;  // index in level actors
+        std::vector<std::string> mMeshes;  // every mesh its actors use, once
+        std::vector<ActorHandle> mSpawned;  // first mSpawned.size() entries of mActors exist
+        AssetLoad mAssets;
+        JobCounter mAssetJob;
+    };
+
+    void Stream(const Vector3& center, bool blocking);
+    void StartAssetLoad(Cell& cell);
+    void ReleaseAssets(Cell& cell);
+
+    class Game* mGame = nullptr;
+    LevelLoader mLoader;  // actor types and components
+
+    std::vector<LevelActor> mActors;
+    float mCellSize = 0;
+    int mLoadRadius = 1;
+    // Cells with nothing in them aren't stored
+    std::vector<std::unique_ptr<Cell>> mCells;
+    // Loaded or loading cells using a mesh, the renderer frees it at 0
+    std::unordered_map<std::string, int> mMeshRefs;
+
+    float mFrameBudget = 2.0f;
+    bool mBlocking = false;
+};
@@ -1,6 +1,10 @@
 #include "Collision.hpp"
 #include <algorithm>
 #include <array>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define COLLISION_SSE
+#endif
 
 LineSegment::LineSegment(const Vector3 &start, const Vector3 &end)
         : mStart(start), mEnd(end) {}
@@ -166,6 +170,19 @@ void AABB::Rotate(const Quaternion &q) {
     }
 }
 
+void AABB::Transform(const Matrix4 &mat) {
+    // Center moves with the transform, half extents grow by the absolute rotation/scale part
+    Vector3 center = (mMin + mMax) * 0.5f;
+    Vector3 extents = (mMax - mMin) * 0.5f;
+    center = Vector3::Transform(center, mat);
+    Vector3 newExtents;
+    newExtents.x = extents.x * Math::Abs(mat.mat[0][0]) + extents.y * Math::Abs(mat.mat[1][0]) + extents.z * Math::Abs(mat.mat[2][0]);
+    newExtents.y = extents.x * Math::Abs(mat.mat[0][1]) + extents.y * Math::Abs(mat.mat[1][1]) + extents.z * Math::Abs(mat.mat[2][1]);
+    newExtents.z = extents.x * Math::Abs(mat.mat[0][2]) + extents.y * Math::Abs(mat.mat[1][2]) + extents.z * Math::Abs(mat.mat[2][2]);
+    mMin = center - newExtents;
+    mMax = center + newExtents;
+}
+
 bool AABB::Contains(const Vector3 &point) const {
     bool outside = point.x < mMin.x ||
                    point.y < mMin.y ||
@@ -393,3 +410,73 @@ bool SweptSphere(const Sphere &P0, const Sphere &P1,
         }
     }
 }
+
+Frustum::Frustum(const Matrix4 &viewProj) {
+    // Clip = v * viewProj, inside when -w <= x, y, z <= w. Each bound is a plane made of matrix columns
+    auto column = [&viewProj](int i) {
+        return std::array<float, 4>{viewProj.mat[0][i], viewProj.mat[1][i], viewProj.mat[2][i], viewProj.mat[3][i]};
+    };
+    std::array<float, 4> w = column(3);
+    for (int axis = 0; axis < 3; axis++) {
+        std::array<float, 4> c = column(axis);
+        for (float sign: {1.0f, -1.0f}) {
+            Vector3 normal(w[0] + sign * c[0], w[1] + sign * c[1], w[2] + sign * c[2]);
+            float length = normal.Length();
+            // SignedDist is dot(p, n) - d
+            mPlanes.emplace_back(normal * (1.0f / length), -(w[3] + sign * c[3]) / length);
+        }
+    }
+}
+
+bool Intersect(const Frustum &f, const Sphere &s) {
+    for (const auto &plane: f.mPlanes) {
+        if (plane.SignedDist(s.mCenter) < -s.mRadius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Intersect(const Frustum &f, const AABB &box) {
+    for (const auto &plane: f.mPlanes) {
+        // Corner furthest along the normal, if it's outside the whole box is
+        Vector3 corner(plane.mNormal.x >= 0.0f ? box.mMax.x : box.mMin.x,
+                       plane.mNormal.y >= 0.0f ? box.mMax.y : box.mMin.y,
+                       plane.mNormal.z >= 0.0f ? box.mMax.z : box.mMin.z);
+        if (plane.SignedDist(corner) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Intersect(const Frustum &f, const Sphere *spheres, size_t count, uint8_t *outInside) {
+    size_t i = 0;
+#ifdef COLLISION_SSE
+    static_assert(sizeof(Sphere) == sizeof(float) * 4, "spheres are loaded as center xyz + radius");
+    for (; i + 4 <= count; i += 4) {
+        // Four spheres, transposed to x, y, z, radius of all four
+        __m128 x = _mm_loadu_ps(&spheres[i].mCenter.x);
+        __m128 y = _mm_loadu_ps(&spheres[i + 1].mCenter.x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2].mCenter.x);
+        __m128 radius = _mm_loadu_ps(&spheres[i + 3].mCenter.x);
+        _MM_TRANSPOSE4_PS(x, y, z, radius);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+        int inside = 0xF;
+        for (const auto &plane: f.mPlanes) {
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.mNormal.x)),
+                                                _mm_mul_ps(y, _mm_set1_ps(plane.mNormal.y))),
+                                     _mm_mul_ps(z, _mm_set1_ps(plane.mNormal.z)));
+            dist = _mm_sub_ps(dist, _mm_set1_ps(plane.mD));
+            inside &= _mm_movemask_ps(_mm_cmpge_ps(dist, negRadius));
+        }
+        for (size_t j = 0; j < 4; j++) {
+            outInside[i + j] = static_cast<uint8_t>((inside >> j) & 1);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        outInside[i] = static_cast<uint8_t>(Intersect(f, spheres[i]));
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Math.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 struct LineSegment {
@@ -50,6 +52,8 @@ struct AABB {
 
     // Rotated by a quaternion
     void Rotate(const Quaternion &q);
+    // Box around this one after a transform (rotation, scale, translation)
+    void Transform(const Matrix4 &mat);
 
     [[nodiscard]] bool Contains(const Vector3 &point) const;
     [[nodiscard]] float MinDistSq(const Vector3 &point) const;
@@ -76,6 +80,14 @@ struct Capsule {
     float mRadius;
 };
 
+// View volume as six planes with normals pointing inside
+struct Frustum {
+    // From a view-projection matrix, OpenGL clip space
+    explicit Frustum(const Matrix4 &viewProj);
+
+    std::vector<Plane> mPlanes;
+};
+
 struct ConvexPolygon {
     [[nodiscard]] bool Contains(const Vector2 &point) const;
 
@@ -91,6 +103,10 @@ bool Intersect(const Sphere &s, const AABB &box);
 bool Intersect(const LineSegment &l, const Sphere &s, float &outT);
 bool Intersect(const LineSegment &l, const Plane &p, float &outT);
 bool Intersect(const LineSegment &l, const AABB &b, float &outT, Vector3 &outNorm);
+bool Intersect(const Frustum &f, const Sphere &s);
+bool Intersect(const Frustum &f, const AABB &box);
+// Many spheres against one frustum, 4 at a time with SSE. outInside[i] is 1 if spheres[i] touches the frustum
+void Intersect(const Frustum &f, const Sphere *spheres, size_t count, uint8_t *outInside);
 
 // Continuous collision detection
 bool SweptSphere(const Sphere &P0, const Sphere &P1, const Sphere &Q0, const Sphere &Q1, float &t);
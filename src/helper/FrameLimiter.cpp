@@ -0,0 +1,97 @@
+#include "FrameLimiter.hpp"
+#include <algorithm>
+#include <cmath>
+
+void FrameLimiter::Reset() {
+    // Query here instead of constructor, SDL might not be initialized yet
+    mFrequency = SDL_GetPerformanceFrequency();
+    UpdateTargetTicks();
+    mLastCounter = SDL_GetPerformanceCounter();
+    mNextDeadline = mLastCounter + mTargetTicks;
+    mHistoryIndex = 0;
+    mHistoryCount = 0;
+}
+
+void FrameLimiter::SetTargetRate(float hz) {
+    mTargetRate = std::max(hz, 0.0f);
+    UpdateTargetTicks();
+    mNextDeadline = mLastCounter + mTargetTicks;
+}
+
+void FrameLimiter::UpdateTargetTicks() {
+    mTargetTicks = mTargetRate > 0 ? static_cast<Uint64>(static_cast<double>(mFrequency) / mTargetRate) : 0;
+}
+
+float FrameLimiter::WaitForNextFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    if (mTargetTicks > 0) {
+        // Sleep most of the remaining time, the OS scheduler isn't precise so leave a margin
+        const auto spinTicks = static_cast<Uint64>(SPIN_THRESHOLD * static_cast<float>(mFrequency));
+        while (now + spinTicks < mNextDeadline) {
+            Uint64 sleepTicks = mNextDeadline - now - spinTicks;
+            auto sleepMs = static_cast<Uint32>(sleepTicks * 1000 / mFrequency);
+            if (sleepMs == 0) break;
+            SDL_Delay(sleepMs);
+            now = SDL_GetPerformanceCounter();
+        }
+
+        // Spin the last bit on the high resolution counter
+        while (now < mNextDeadline) {
+            now = SDL_GetPerformanceCounter();
+        }
+
+        // Schedule from the deadline to avoid drift, unless we're more than a frame late (hitch)
+        if (now - mNextDeadline < mTargetTicks) {
+            mNextDeadline += mTargetTicks;
+        } else {
+            mNextDeadline = now + mTargetTicks;
+        }
+    }
+
+    auto frameTime = static_cast<float>(static_cast<double>(now - mLastCounter) / static_cast<double>(mFrequency));
+    mLastCounter = now;
+    RecordFrame(frameTime);
+    return frameTime;
+}
+
+void FrameLimiter::RecordFrame(float frameTime) {
+    mFrameTimes[mHistoryIndex] = frameTime;
+    mHistoryIndex = (mHistoryIndex + 1) % HISTORY_SIZE;
+    mHistoryCount = std::min(mHistoryCount + 1, HISTORY_SIZE);
+}
+
+FrameLimiter::Stats FrameLimiter::GetStats() const {
+    Stats stats;
+    if (mHistoryCount == 0) {
+        return stats;
+    }
+
+    // Uncapped has no target, report error against mean instead
+    float sum = 0;
+    for (size_t i = 0; i < mHistoryCount; i++) {
+        sum += mFrameTimes[i];
+    }
+    stats.mMeanFrameTime = sum / static_cast<float>(mHistoryCount);
+    float target = mTargetRate > 0 ? 1.0f / mTargetRate : stats.mMeanFrameTime;
+
+    float variance = 0;
+    for (size_t i = 0; i < mHistoryCount; i++) {
+        float error = mFrameTimes[i] - target;
+        stats.mMeanError += error;
+        stats.mMaxError = std::max(stats.mMaxError, std::fabs(error));
+        float diff = mFrameTimes[i] - stats.mMeanFrameTime;
+        variance += diff * diff;
+    }
+    stats.mMeanError /= static_cast<float>(mHistoryCount);
+    stats.mJitter = std::sqrt(variance / static_cast<float>(mHistoryCount));
+    stats.mFrames = static_cast<unsigned int>(mHistoryCount);
+    return stats;
+}
+
+void FrameLimiter::LogStats() const {
+    Stats stats = GetStats();
+    SDL_Log("Frame pacing over %u frames: target %.1f hz, mean %.3f ms, mean error %.3f ms, max error %.3f ms, jitter %.3f ms",
+            stats.mFrames, mTargetRate, stats.mMeanFrameTime * 1000.0f, stats.mMeanError * 1000.0f,
+            stats.mMaxError * 1000.0f, stats.mJitter * 1000.0f);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL.h>
+#include <array>
+
+class FrameLimiter {
+public:
+    FrameLimiter() = default;
+
+    // Restart timing from now (call after SDL_Init, before entering the loop)
+    void Reset();
+
+    // Target frame rate in hz, <= 0 means uncapped
+    void SetTargetRate(float hz);
+    [[nodiscard]] float GetTargetRate() const { return mTargetRate; }
+
+    // Block until next frame is due, return real time since last frame in second
+    float WaitForNextFrame();
+
+    // Pacing error is actual frame time minus target frame time (in second)
+    struct Stats {
+        float mMeanError = 0;
+        float mMaxError = 0;
+        float mJitter = 0;  // standard deviation of frame time
+        float mMeanFrameTime = 0;
+        unsigned int mFrames = 0;  // number of frames in history
+    };
+    [[nodiscard]] Stats GetStats() const;
+    void LogStats() const;
+
+private:
+    void UpdateTargetTicks();
+    void RecordFrame(float frameTime);
+
+    // Coarse sleep until this much time is left, then spin for precision
+    constexpr static float SPIN_THRESHOLD = 0.002f;
+    constexpr static size_t HISTORY_SIZE = 240;
+
+    Uint64 mFrequency = 0;  // performance counter ticks per second
+    Uint64 mTargetTicks = 0;  // ticks per frame, 0 when uncapped
+    Uint64 mLastCounter = 0;  // counter at last frame start
+    Uint64 mNextDeadline = 0;  // when the next frame should start
+    float mTargetRate = 60;
+
+    // Ring buffer of recent frame times
+    std::array<float, HISTORY_SIZE> mFrameTimes{};
+    size_t mHistoryIndex = 0;
+    size_t mHistoryCount = 0;
+};
@@ -689,6 +689,20 @@ Matrix4 Matrix4::CreateFromQuaternion(const class Quaternion &q) {
     return Matrix4(mat);
 }
 
+Matrix4 Matrix4::CreateTransform(float scale, const Quaternion &q, const Vector3 &trans) {
+    // Rotation rows scaled, translation in the last row
+    Matrix4 result = CreateFromQuaternion(q);
+    for (int i = 0; i < 3; i++) {
+        result.mat[i][0] *= scale;
+        result.mat[i][1] *= scale;
+        result.mat[i][2] *= scale;
+    }
+    result.mat[3][0] = trans.x;
+    result.mat[3][1] = trans.y;
+    result.mat[3][2] = trans.z;
+    return result;
+}
+
 Matrix4 Matrix4::CreateTranslation(const Vector3 &trans) {
     float temp[4][4] =
             {
@@ -222,6 +222,9 @@ public:
 
     static Matrix4 CreateTranslation(const Vector3 &trans);
 
+    // Same as CreateScale * CreateFromQuaternion * CreateTranslation without the two multiplies
+    static Matrix4 CreateTransform(float scale, const class Quaternion &q, const Vector3 &trans);
+
     static Matrix4 CreateLookAt(const Vector3 &eye, const Vector3 &target, const Vector3 &up);
 
     static Matrix4 CreateOrtho(float width, float height, float near, float far);
@@ -8,8 +8,19 @@
 #include "VertexArray.hpp"
 #include "Math.hpp"
 #include "../core/Renderer.hpp"
+#include "Profiler.hpp"
 
 bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
+    PROFILE_SCOPE("Mesh::Load");
+    if (!Parse(fileName)) {
+        return false;
+    }
+    Upload(renderer);
+    return true;
+}
+
+bool Mesh::Parse(const std::string &fileName) {
+    PROFILE_SCOPE("Mesh::Parse");
     std::ifstream file(fileName);
     if (!file.is_open()) {
         SDL_Log("File not found: Mesh %s", fileName.c_str());
@@ -38,10 +49,6 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
 
     mShaderName = doc["shader"].GetString();
 
-    // Skip the vertex format/shader for now
-    // (This is changed in a later chapter's code)
-    size_t vertSize = 8;
-
     // Load textures
     const rapidjson::Value &textures = doc["textures"];
     if (!textures.IsArray() || textures.Size() < 1) {
@@ -51,19 +58,9 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
 
     mSpecPower = static_cast<float>(doc["specularPower"].GetDouble());
 
+    // Only names here, textures are resolved on upload
     for (rapidjson::SizeType i = 0; i < textures.Size(); i++) {
-        // Is this texture already loaded?
-        std::string texName = textures[i].GetString();
-        Texture *t = renderer->GetTexture(texName);
-        if (t == nullptr) {
-            // Try loading the texture
-            t = renderer->GetTexture(texName);
-            if (t == nullptr) {
-                // If it's still null, just use the default texture
-                t = renderer->GetTexture("Assets/Default.png");
-            }
-        }
-        mTextures.emplace_back(t);
+        mTextureNames.emplace_back(textures[i].GetString());
     }
 
     // Load in the vertices
@@ -74,8 +71,9 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
         return false;
     }
 
-    std::vector<float> vertices;
-    vertices.reserve(vertsJson.Size() * vertSize);
+    // Skip the vertex format/shader for now
+    // (This is changed in a later chapter's code)
+    mVertices.reserve(vertsJson.Size() * VERTEX_SIZE);
     mRadius = 0.0f;
     for (rapidjson::SizeType i = 0; i < vertsJson.Size(); i++) {
         // For now, just assume we have 8 elements
@@ -91,7 +89,7 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
 
         // Add the floats
         for (rapidjson::SizeType i = 0; i < vert.Size(); i++) {
-            vertices.emplace_back(static_cast<float>(vert[i].GetDouble()));
+            mVertices.emplace_back(static_cast<float>(vert[i].GetDouble()));
         }
     }
 
@@ -105,8 +103,7 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
         return false;
     }
 
-    std::vector<unsigned int> indices;
-    indices.reserve(indJson.Size() * 3);
+    mIndices.reserve(indJson.Size() * 3);
     for (rapidjson::SizeType i = 0; i < indJson.Size(); i++) {
         const rapidjson::Value &ind = indJson[i];
         if (!ind.IsArray() || ind.Size() != 3) {
@@ -114,17 +111,29 @@ bool Mesh::Load(const std::string &fileName, Renderer *renderer) {
             return false;
         }
 
-        indices.emplace_back(ind[0].GetUint());
-        indices.emplace_back(ind[1].GetUint());
-        indices.emplace_back(ind[2].GetUint());
+        mIndices.emplace_back(ind[0].GetUint());
+        mIndices.emplace_back(ind[1].GetUint());
+        mIndices.emplace_back(ind[2].GetUint());
     }
 
-    // Now create a vertex array
-    mVertexArray = new VertexArray(vertices.data(), static_cast<unsigned>(vertices.size()) / vertSize,
-                                   indices.data(), static_cast<unsigned>(indices.size()));
     return true;
 }
 
+void Mesh::Upload(Renderer *renderer) {
+    for (const auto &texName: mTextureNames) {
+        Texture *t = renderer->GetMeshTexture(texName);
+        if (t == nullptr) {
+            // If it's still null, just use the default texture
+            t = renderer->GetMeshTexture("Assets/Default.png");
+        }
+        mTextures.emplace_back(t);
+    }
+
+    // Now create a vertex array (renderer decides, headless renderer doesn't create one)
+    mVertexArray = renderer->CreateVertexArray(mVertices.data(), static_cast<unsigned>(mVertices.size()) / VERTEX_SIZE,
+                                               mIndices.data(), static_cast<unsigned>(mIndices.size()));
+}
+
 void Mesh::Unload() {
     delete mVertexArray;
     mVertexArray = nullptr;
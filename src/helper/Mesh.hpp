@@ -13,6 +13,19 @@ public:
     bool Load(const std::string &fileName, class Renderer *renderer);
     void Unload();
 
+    // Split load: parse the file on any thread, then resolve textures and create
+    // the vertex array on the GL thread
+    bool Parse(const std::string &fileName);
+    void Upload(class Renderer *renderer);
+    // Textures named by the parsed file, for preloading them before upload
+    [[nodiscard]] const std::vector<std::string> &GetTextureNames() const { return mTextureNames; }
+
+    // Object space vertices (VERTEX_SIZE floats each: position, normal, uv) and triangle indices,
+    // kept after upload for merging static meshes
+    constexpr static unsigned int VERTEX_SIZE = 8;
+    [[nodiscard]] const std::vector<float> &GetVertices() const { return mVertices; }
+    [[nodiscard]] const std::vector<unsigned int> &GetIndices() const { return mIndices; }
+
     // Get the vertex array associated with this mesh
     class VertexArray *GetVertexArray() { return mVertexArray; }
     // Get a texture from specified index
@@ -40,4 +53,9 @@ private:
     float mSpecPower = 100.0f;
     // AABB collision
     AABB mBox;
+
+    // Parsed data, vertices and indices are also on the GPU after upload
+    std::vector<std::string> mTextureNames;
+    std::vector<float> mVertices;
+    std::vector<unsigned int> mIndices;
 };
\ No newline at end of file
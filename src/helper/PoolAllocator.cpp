@@ -0,0 +1,86 @@
+#include "PoolAllocator.hpp"
+#include <algorithm>
+#include <new>
+#include <SDL_log.h>
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk)
+        : mBlockSize(std::max(blockSize, sizeof(FreeBlock))), mBlocksPerChunk(blocksPerChunk) {}
+
+PoolAllocator::~PoolAllocator() {
+    for (auto chunk: mChunks) {
+        ::operator delete(chunk);
+    }
+}
+
+void *PoolAllocator::Allocate() {
+    if (!mFreeList) {
+        AllocateChunk();
+    }
+
+    // Pop from free list
+    FreeBlock *block = mFreeList;
+    mFreeList = block->mNext;
+    mLiveCount++;
+    return block;
+}
+
+void PoolAllocator::Free(void *ptr) {
+    // Push to free list, recently freed block is reused first (still in cache)
+    auto *block = static_cast<FreeBlock *>(ptr);
+    block->mNext = mFreeList;
+    mFreeList = block;
+    mLiveCount--;
+}
+
+void PoolAllocator::AllocateChunk() {
+    char *chunk = static_cast<char *>(::operator new(mBlockSize * mBlocksPerChunk));
+    mChunks.emplace_back(chunk);
+
+    // Thread blocks in address order so consecutive allocations are contiguous
+    for (size_t i = mBlocksPerChunk; i > 0; i--) {
+        auto *block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * mBlockSize);
+        block->mNext = mFreeList;
+        mFreeList = block;
+    }
+}
+
+ObjectPool::PoolArray &ObjectPool::GetPools() {
+    static PoolArray pools;
+    return pools;
+}
+
+PoolAllocator *ObjectPool::GetPool(size_t size) {
+    size_t index = (size + GRANULARITY - 1) / GRANULARITY;
+    auto &pool = GetPools()[index];
+    if (!pool) {
+        pool = std::make_unique<PoolAllocator>(index * GRANULARITY);
+    }
+    return pool.get();
+}
+
+void *ObjectPool::Allocate(size_t size) {
+    if (size > MAX_POOLED_SIZE) {
+        return ::operator new(size);
+    }
+    return GetPool(size)->Allocate();
+}
+
+void ObjectPool::Free(void *ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (size > MAX_POOLED_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+    GetPool(size)->Free(ptr);
+}
+
+void ObjectPool::LogStats() {
+    for (auto &pool: GetPools()) {
+        if (pool) {
+            SDL_Log("Object pool %zu bytes: %zu live / %zu capacity",
+                    pool->GetBlockSize(), pool->GetLiveCount(), pool->GetCapacity());
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Fixed size block allocator. Memory comes from arena chunks, freed blocks go to an intrusive free list
+// so alloc/free are O(1) and never touch the general heap after the chunk exists.
+// Not thread safe, create/delete actors and components on the main thread.
+class PoolAllocator {
+public:
+    explicit PoolAllocator(size_t blockSize, size_t blocksPerChunk = 128);
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator &) = delete;
+    PoolAllocator &operator=(const PoolAllocator &) = delete;
+
+    void *Allocate();
+    void Free(void *ptr);
+
+    // Getter
+    [[nodiscard]] size_t GetBlockSize() const { return mBlockSize; }
+    [[nodiscard]] size_t GetLiveCount() const { return mLiveCount; }
+    [[nodiscard]] size_t GetCapacity() const { return mChunks.size() * mBlocksPerChunk; }
+
+private:
+    void AllocateChunk();
+
+    struct FreeBlock {
+        FreeBlock *mNext;
+    };
+
+    std::vector<char *> mChunks;
+    FreeBlock *mFreeList = nullptr;
+    size_t mBlockSize;
+    size_t mBlocksPerChunk;
+    size_t mLiveCount = 0;
+};
+
+// Size class pools used by Actor and Component operator new/delete.
+// Each concrete type has its own size so in practice objects of one type share one arena.
+class ObjectPool {
+public:
+    static void *Allocate(size_t size);
+    static void Free(void *ptr, size_t size);
+
+    static void LogStats();
+
+private:
+    constexpr static size_t GRANULARITY = alignof(std::max_align_t);
+    constexpr static size_t MAX_POOLED_SIZE = 1024;  // bigger objects go to the heap
+    constexpr static size_t NUM_POOLS = MAX_POOLED_SIZE / GRANULARITY + 1;
+
+    // Function static so pools exist before any static actor/component could be created
+    using PoolArray = std::array<std::unique_ptr<PoolAllocator>, NUM_POOLS>;
+    static PoolArray &GetPools();
+    static PoolAllocator *GetPool(size_t size);
+};
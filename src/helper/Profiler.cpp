@@ -0,0 +1,112 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    struct ZoneEvent {
+        const char *mName;
+        Uint64 mStart;
+        Uint64 mEnd;
+    };
+
+    // Events kept per thread, oldest gets overwritten (~1000 frames of default zones)
+    constexpr size_t RING_CAPACITY = 1 << 16;
+}
+
+struct Profiler::ThreadBuffer {
+    std::mutex mMutex;  // only contended while dumping
+    std::vector<ZoneEvent> mEvents;
+    size_t mNext = 0;
+    bool mWrapped = false;
+    unsigned int mThreadID = 0;
+    std::string mName;
+};
+
+namespace {
+    // Buffers live until exit, so a trace can still be written after a thread ended
+    std::mutex sRegistryMutex;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> sBuffers;
+    thread_local Profiler::ThreadBuffer *tBuffer = nullptr;
+    const Uint64 sStartCounter = SDL_GetPerformanceCounter();
+}
+
+Profiler::ThreadBuffer &Profiler::GetThreadBuffer() {
+    if (!tBuffer) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->mEvents.resize(RING_CAPACITY);
+
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        buffer->mThreadID = static_cast<unsigned int>(sBuffers.size());
+        buffer->mName = buffer->mThreadID == 0 ? "Main" : "Thread " + std::to_string(buffer->mThreadID);
+        tBuffer = buffer.get();
+        sBuffers.emplace_back(std::move(buffer));
+    }
+    return *tBuffer;
+}
+
+void Profiler::Record(const char *name, Uint64 start, Uint64 end) {
+    ThreadBuffer &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mMutex);
+    buffer.mEvents[buffer.mNext] = {name, start, end};
+    if (++buffer.mNext == RING_CAPACITY) {
+        buffer.mNext = 0;
+        buffer.mWrapped = true;
+    }
+}
+
+void Profiler::SetThreadName(const std::string &name) {
+    ThreadBuffer &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mMutex);
+    buffer.mName = name;
+}
+
+bool Profiler::WriteChromeTrace(const std::string &fileName) {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        SDL_Log("Failed to open profile trace %s", fileName.c_str());
+        return false;
+    }
+
+    // Trace timestamps are in microseconds
+    const double toMicro = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    size_t numEvents = 0;
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard<std::mutex> registryLock(sRegistryMutex);
+    for (auto &buffer: sBuffers) {
+        std::lock_guard<std::mutex> lock(buffer->mMutex);
+
+        // Thread name metadata
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+             << buffer->mThreadID << ",\"args\":{\"name\":\"" << buffer->mName << "\"}}";
+        first = false;
+
+        // Complete events, nesting is derived from time containment
+        size_t count = buffer->mWrapped ? RING_CAPACITY : buffer->mNext;
+        size_t begin = buffer->mWrapped ? buffer->mNext : 0;
+        for (size_t i = 0; i < count; i++) {
+            const ZoneEvent &e = buffer->mEvents[(begin + i) % RING_CAPACITY];
+            file << ",\n{\"name\":\"" << e.mName << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->mThreadID
+                 << ",\"ts\":" << static_cast<double>(e.mStart - sStartCounter) * toMicro
+                 << ",\"dur\":" << static_cast<double>(e.mEnd - e.mStart) * toMicro << "}";
+        }
+        numEvents += count;
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    SDL_Log("Wrote %zu profile zones to %s", numEvents, fileName.c_str());
+    return true;
+}
+
+void Profiler::Clear() {
+    std::lock_guard<std::mutex> registryLock(sRegistryMutex);
+    for (auto &buffer: sBuffers) {
+        std::lock_guard<std::mutex> lock(buffer->mMutex);
+        buffer->mNext = 0;
+        buffer->mWrapped = false;
+    }
+}
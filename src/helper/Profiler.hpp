@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+
+// Compile out all zones with -DENABLE_PROFILER=0
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+// CPU zone profiler, every thread records finished zones into its own ring buffer.
+// Nested zones show up as a hierarchy in chrome://tracing or Perfetto.
+class Profiler {
+public:
+    // Record a finished zone for the calling thread (name must be a string literal)
+    static void Record(const char *name, Uint64 start, Uint64 end);
+
+    // Name shown for the calling thread in the trace
+    static void SetThreadName(const std::string &name);
+
+    // Write all recorded zones as chrome trace event JSON
+    static bool WriteChromeTrace(const std::string &fileName);
+
+    // Drop all recorded zones
+    static void Clear();
+
+    // Opaque per thread ring buffer, defined in Profiler.cpp
+    struct ThreadBuffer;
+
+private:
+    static ThreadBuffer &GetThreadBuffer();
+};
+
+// RAII zone, use PROFILE_SCOPE instead of creating this directly
+class ProfileZone {
+public:
+    explicit ProfileZone(const char *name) : mName(name), mStart(SDL_GetPerformanceCounter()) {}
+    ~ProfileZone() { Profiler::Record(mName, mStart, SDL_GetPerformanceCounter()); }
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *mName;
+    Uint64 mStart;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
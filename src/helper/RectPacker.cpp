@@ -0,0 +1,33 @@
+#include "RectPacker.hpp"
+#include <algorithm>
+#include <numeric>
+
+bool RectPacker::Pack(std::vector<Rect> &rects, int width, int height, int padding) {
+    // Tallest first keeps shelves tight, ties broken by index so the layout is the same every run
+    std::vector<size_t> order(rects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&rects](size_t a, size_t b) {
+        return rects[a].mHeight != rects[b].mHeight ? rects[a].mHeight > rects[b].mHeight : a < b;
+    });
+
+    int shelfY = padding;
+    int shelfHeight = 0;
+    int x = padding;
+    for (auto index: order) {
+        Rect &rect = rects[index];
+        if (x + rect.mWidth + padding > width) {
+            // Next shelf
+            shelfY += shelfHeight + padding;
+            shelfHeight = 0;
+            x = padding;
+        }
+        if (x + rect.mWidth + padding > width || shelfY + rect.mHeight + padding > height) {
+            return false;
+        }
+        rect.mX = x;
+        rect.mY = shelfY;
+        x += rect.mWidth + padding;
+        shelfHeight = std::max(shelfHeight, rect.mHeight);
+    }
+    return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+// Place rectangles inside a fixed area on shelves: tallest first, left to right, a new shelf above when a row is full.
+// Fast and good enough for UI images of similar height
+class RectPacker {
+public:
+    struct Rect {
+        int mWidth = 0;
+        int mHeight = 0;
+        // Output, bottom left corner
+        int mX = 0;
+        int mY = 0;
+    };
+
+    // Fill mX/mY of every rect, padding is left empty around each one. Return false if they don't all fit
+    static bool Pack(std::vector<Rect> &rects, int width, int height, int padding);
+};
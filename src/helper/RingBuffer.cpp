@@ -0,0 +1,114 @@
+#include "RingBuffer.hpp"
+#include <glad/glad.h>
+#include <SDL_log.h>
+
+// Not in the GL 3.3 loader, resolved by the renderer when the driver has it
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+static PFNGLBUFFERSTORAGEPROC sBufferStorage = nullptr;
+
+RingBuffer::RingBuffer(size_t frameSize) {
+    Create(frameSize);
+}
+
+RingBuffer::~RingBuffer() {
+    for (auto &fence: mFences) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    for (const auto &retired: mRetired) {
+        Destroy(retired.first, mPersistent != nullptr);
+    }
+    Destroy(mBuffer, mPersistent != nullptr);
+}
+
+void RingBuffer::SetBufferStorage(void *proc) {
+    sBufferStorage = reinterpret_cast<PFNGLBUFFERSTORAGEPROC>(proc);
+}
+
+void RingBuffer::BeginFrame() {
+    mFrame = (mFrame + 1) % FRAME_COUNT;
+    mHead = 0;
+    if (GLsync fence = mFences[mFrame]) {
+        // Usually signaled long ago, only waits when the GPU is FRAME_COUNT frames behind
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        mFences[mFrame] = nullptr;
+    }
+
+    // Last used FRAME_COUNT frames ago, the fence above covered it
+    for (size_t i = 0; i < mRetired.size();) {
+        if (--mRetired[i].second == 0) {
+            Destroy(mRetired[i].first, mPersistent != nullptr);
+            mRetired.erase(mRetired.begin() + static_cast<long>(i));
+        } else {
+            i++;
+        }
+    }
+}
+
+void *RingBuffer::Map(size_t size, size_t alignment, size_t &outOffset) {
+    size_t start = (mHead + alignment - 1) / alignment * alignment;
+    if (start + size > mFrameSize) {
+        // Fresh buffer twice as big, draws already submitted keep reading the old one
+        size_t frameSize = mFrameSize * 2;
+        while (frameSize < size) {
+            frameSize *= 2;
+        }
+        SDL_Log("Ring buffer region full, growing to %zu bytes", frameSize);
+        mRetired.emplace_back(mBuffer, FRAME_COUNT);
+        Create(frameSize);
+        start = 0;
+    }
+    mHead = start + size;
+    outOffset = mFrame * mFrameSize + start;
+
+    if (mPersistent) {
+        return mPersistent + outOffset;
+    }
+    // The fence already guarantees the GPU is done with this range, skip the driver's own sync
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+    return glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(outOffset), static_cast<GLsizeiptr>(size),
+                            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void RingBuffer::Unmap() {
+    // Coherent persistent mapping, writes are visible to draws issued after this
+    if (!mPersistent) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+}
+
+void RingBuffer::EndFrame() {
+    mFences[mFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void RingBuffer::Create(size_t frameSize) {
+    mFrameSize = frameSize;
+    auto size = static_cast<GLsizeiptr>(frameSize * FRAME_COUNT);
+
+    // Copy write target so the array/uniform bindings of the caller are left alone
+    glGenBuffers(1, &mBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+    if (sBufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        sBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+        mPersistent = static_cast<unsigned char *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+void RingBuffer::Destroy(unsigned int buffer, bool mapped) {
+    if (mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    glDeleteBuffers(1, &buffer);
+}
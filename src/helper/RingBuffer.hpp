@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Stream per frame GPU data (instance transforms, sprite vertices, uniforms) without reallocating a buffer.
+// The buffer is split in FRAME_COUNT regions, the CPU writes one while the GPU reads the others, and a
+// fence per region makes sure it's free before it's written again. Mapped once for good when
+// GL_ARB_buffer_storage is there, otherwise each allocation maps its range unsynchronized
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t frameSize);
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    // glBufferStorage from the context, nullptr if the extension isn't supported. Set before creating buffers
+    static void SetBufferStorage(void *proc);
+
+    // Move to the next region, waits if the GPU still reads it from FRAME_COUNT frames ago
+    void BeginFrame();
+    // Room for size bytes in this frame's region, outOffset is where it starts in GetBuffer().
+    // A full region grows the buffer, draw from the buffer id read after this call
+    void *Map(size_t size, size_t alignment, size_t &outOffset);
+    // Done writing the last Map, before drawing from it
+    void Unmap();
+    // Fence the region once the frame's draws reading it are submitted
+    void EndFrame();
+
+    [[nodiscard]] unsigned int GetBuffer() const { return mBuffer; }
+    [[nodiscard]] bool IsPersistent() const { return mPersistent != nullptr; }
+
+private:
+    void Create(size_t frameSize);
+    void Destroy(unsigned int buffer, bool mapped);
+
+    // OpenGL ID of the buffer
+    unsigned int mBuffer = 0;
+    size_t mFrameSize = 0;
+    size_t mFrame = 0;  // region written this frame
+    size_t mHead = 0;  // next free byte in the region
+    unsigned char *mPersistent = nullptr;  // whole buffer, when persistently mapped
+
+    constexpr static size_t FRAME_COUNT = 3;
+    struct __GLsync *mFences[FRAME_COUNT] = {};
+    // Buffers replaced by a bigger one, deleted once the frames drawing from them are done.
+    // Deleting right away would also unbind the ranges already bound this frame
+    std::vector<std::pair<unsigned int, size_t>> mRetired;  // buffer, frames left
+};
@@ -0,0 +1,114 @@
+#include "SpriteBatch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+#include "Texture.hpp"
+#include "RingBuffer.hpp"
+
+SpriteBatch::SpriteBatch(RingBuffer *ring) : mRing(ring) {
+    // Vertices come from the ring buffer at a new offset every frame, indices only change when the batch grows
+    glGenVertexArrays(1, &mVertexArray);
+    glBindVertexArray(mVertexArray);
+    glGenBuffers(1, &mIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+
+    // Same locations as mesh vertex arrays, no normal
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(2);
+}
+
+SpriteBatch::~SpriteBatch() {
+    glDeleteBuffers(1, &mIndexBuffer);
+    glDeleteVertexArrays(1, &mVertexArray);
+}
+
+void SpriteBatch::Begin() {
+    mQuads.clear();
+    mVertices.clear();
+}
+
+void SpriteBatch::Draw(Texture *texture, const Matrix4 &world, int drawOrder) {
+    if (!texture) {
+        return;
+    }
+    mQuads.push_back({texture, drawOrder, static_cast<uint32_t>(mVertices.size() / VERTEX_SIZE)});
+
+    // Corners and texture coords of the sprite quad, image rows were flipped on load.
+    // Coords are scaled to the texture's atlas region
+    const float corners[4][4] = {
+            {-0.5f, 0.5f, 0.f, 1.f},  // top left
+            {0.5f, 0.5f, 1.f, 1.f},  // top right
+            {0.5f, -0.5f, 1.f, 0.f},  // bottom right
+            {-0.5f, -0.5f, 0.f, 0.f}  // bottom left
+    };
+    const Vector2 &uvMin = texture->GetUVMin();
+    const Vector2 &uvMax = texture->GetUVMax();
+    for (const auto &corner: corners) {
+        Vector3 pos = Vector3::Transform(Vector3(corner[0], corner[1], 0.0f), world);
+        mVertices.insert(mVertices.end(), {pos.x, pos.y, pos.z,
+                                           Math::Lerp(uvMin.x, uvMax.x, corner[2]),
+                                           Math::Lerp(uvMin.y, uvMax.y, corner[3])});
+    }
+}
+
+void SpriteBatch::Draw(Texture *texture, const Matrix4 &world) {
+    Draw(texture, world, static_cast<int>(mQuads.size()));
+}
+
+void SpriteBatch::End() {
+    if (mQuads.empty()) {
+        return;
+    }
+    // Stable, equal draw order and texture keep their submission order.
+    // Atlas regions share a GL texture, grouping is by that
+    std::stable_sort(mQuads.begin(), mQuads.end(), [](const Quad &a, const Quad &b) {
+        return a.mDrawOrder != b.mDrawOrder ? a.mDrawOrder < b.mDrawOrder :
+               a.mTexture->GetTextureID() < b.mTexture->GetTextureID();
+    });
+
+    // Straight into mapped memory in draw order
+    size_t quadSize = 4 * VERTEX_SIZE * sizeof(float);
+    size_t offset = 0;
+    auto *dest = static_cast<unsigned char *>(mRing->Map(mQuads.size() * quadSize, sizeof(float), offset));
+    for (size_t i = 0; i < mQuads.size(); i++) {
+        memcpy(dest + i * quadSize, mVertices.data() + mQuads[i].mFirstVertex * VERTEX_SIZE, quadSize);
+    }
+    mRing->Unmap();
+
+    glBindVertexArray(mVertexArray);
+    GrowIndexBuffer(mQuads.size());
+    glBindBuffer(GL_ARRAY_BUFFER, mRing->GetBuffer());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * VERTEX_SIZE, reinterpret_cast<void*>(offset));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(float) * VERTEX_SIZE,
+                          reinterpret_cast<void*>(offset + sizeof(float) * 3));
+
+    // One draw per run of the same texture
+    for (size_t first = 0; first < mQuads.size();) {
+        size_t last = first + 1;
+        while (last < mQuads.size() &&
+               mQuads[last].mTexture->GetTextureID() == mQuads[first].mTexture->GetTextureID()) {
+            last++;
+        }
+        mQuads[first].mTexture->SetActive();
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((last - first) * 6), GL_UNSIGNED_INT,
+                       reinterpret_cast<void*>(first * 6 * sizeof(unsigned int)));
+        first = last;
+    }
+}
+
+void SpriteBatch::GrowIndexBuffer(size_t quadCount) {
+    if (quadCount <= mIndexCapacity) {
+        return;
+    }
+    // Double so a growing HUD doesn't rebuild every frame
+    mIndexCapacity = std::max(quadCount, mIndexCapacity * 2);
+    std::vector<unsigned int> indices;
+    indices.reserve(mIndexCapacity * 6);
+    for (unsigned int i = 0; i < mIndexCapacity; i++) {
+        unsigned int v = i * 4;
+        indices.insert(indices.end(), {v, v + 1, v + 2, v + 2, v + 3, v});
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)),
+                 indices.data(), GL_STATIC_DRAW);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math.hpp"
+
+// Collect textured quads for a frame, then draw them with one vertex upload and one draw call per run
+// of quads sharing a texture. Quads are transformed on the CPU, the shader only applies the view-projection.
+// Vertices are written into the frame ring buffer
+class SpriteBatch {
+public:
+    explicit SpriteBatch(class RingBuffer* ring);
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch &) = delete;
+    SpriteBatch &operator=(const SpriteBatch &) = delete;
+
+    void Begin();
+    // Unit quad centered on the origin moved by world (scale it by the texture size).
+    // Sorted by draw order, then GL texture within one draw order
+    void Draw(class Texture* texture, const Matrix4& world, int drawOrder);
+    // Same, kept in the order of the calls, for overlapping UI
+    void Draw(class Texture* texture, const Matrix4& world);
+    // Upload and draw everything since Begin, sprite shader must be active
+    void End();
+
+private:
+    struct Quad {
+        class Texture* mTexture;
+        int mDrawOrder;
+        uint32_t mFirstVertex;  // in mVertices
+    };
+
+    void GrowIndexBuffer(size_t quadCount);
+
+    std::vector<Quad> mQuads;
+    std::vector<float> mVertices;  // submission order, copied to the ring buffer in draw order
+    size_t mIndexCapacity = 0;  // in quads
+    class RingBuffer* mRing = nullptr;
+
+    // OpenGL IDs
+    unsigned int mVertexArray = 0;
+    unsigned int mIndexBuffer = 0;
+
+    // Position is 3 floats, texture coord is 2 floats
+    constexpr static unsigned int VERTEX_SIZE = 5;
+};
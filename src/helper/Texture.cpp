@@ -4,26 +4,51 @@
 #include <SDL.h>
 
 bool Texture::Load(const std::string &fileName) {
-    // // because Opengl and stb read image in different direction
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *bytes = stbi_load(fileName.c_str(), &mWidth, &mHeight, &mChannel, 0);
-    if (!bytes) {
+    if (!Decode(fileName)) {
+        return false;
+    }
+    Upload();
+    return true;
+}
+
+bool Texture::Decode(const std::string &fileName) {
+    // because Opengl and stb read image in different direction, per thread flag so workers can decode
+    stbi_set_flip_vertically_on_load_thread(true);
+    mPixels = stbi_load(fileName.c_str(), &mWidth, &mHeight, &mChannel, 0);
+    if (!mPixels) {
         SDL_Log("stb_image failed to load image %s", fileName.c_str());
         return false;
     }
 
+    return true;
+}
+
+void Texture::Upload() {
     int format = mChannel == 4 ? GL_RGBA : GL_RGB;
 
     // Generate textures
     glGenTextures(1, &mTextureID);
     glBindTexture(GL_TEXTURE_2D, mTextureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, mWidth, mHeight, 0, format, GL_UNSIGNED_BYTE, bytes);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, mWidth, mHeight, 0, format, GL_UNSIGNED_BYTE, mPixels);
 
-    stbi_image_free(bytes);
+    FreePixels();
 
     // Enable bilinear filtering
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void Texture::FreePixels() {
+    stbi_image_free(mPixels);
+    mPixels = nullptr;
+}
+
+bool Texture::LoadDimensions(const std::string &fileName) {
+    // Parse the header only, no pixel decoding
+    if (!stbi_info(fileName.c_str(), &mWidth, &mHeight, &mChannel)) {
+        SDL_Log("stb_image failed to read image %s", fileName.c_str());
+        return false;
+    }
 
     return true;
 }
@@ -42,8 +67,39 @@ void Texture::CreateFromSurface(SDL_Surface *surface) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 }
 
+void Texture::CreateFromPixels(const unsigned char *pixels, int width, int height) {
+    mWidth = width;
+    mHeight = height;
+    mChannel = 4;
+
+    glGenTextures(1, &mTextureID);
+    glBindTexture(GL_TEXTURE_2D, mTextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    // Use linear filtering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void Texture::SetAtlasRegion(const Texture &atlas, int x, int y, int width, int height) {
+    mTextureID = atlas.mTextureID;
+    mAtlasRegion = true;
+    mWidth = width;
+    mHeight = height;
+    mChannel = atlas.mChannel;
+    mUVMin = Vector2(static_cast<float>(x) / static_cast<float>(atlas.mWidth),
+                     static_cast<float>(y) / static_cast<float>(atlas.mHeight));
+    mUVMax = Vector2(static_cast<float>(x + width) / static_cast<float>(atlas.mWidth),
+                     static_cast<float>(y + height) / static_cast<float>(atlas.mHeight));
+}
+
 void Texture::Unload() {
-    glDeleteTextures(1, &mTextureID);
+    FreePixels();
+    // Headless textures never created a GL object
+    if (mTextureID != 0 && !mAtlasRegion) {
+        glDeleteTextures(1, &mTextureID);
+        mTextureID = 0;
+    }
 }
 
 void Texture::SetActive() const {
@@ -1,22 +1,44 @@
 #include <string>
+#include "Math.hpp"
 
 class Texture {
 public:
     Texture() = default;
     ~Texture() = default;
 
+    // Decode then upload, on the thread owning the GL context
     bool Load(const std::string &fileName);
     void Unload();
 
+    // Split load: decode pixels on any thread, then upload on the GL thread (frees the pixels)
+    bool Decode(const std::string &fileName);
+    void Upload();
+    void FreePixels();
+
+    // Only read image dimension without creating the GL texture (headless)
+    bool LoadDimensions(const std::string &fileName);
+
     // Convert from SDL surface to opengl texture
     void CreateFromSurface(struct SDL_Surface* surface);
+    // From RGBA pixels, bottom row first
+    void CreateFromPixels(const unsigned char* pixels, int width, int height);
+    // Part of an atlas texture, binds the atlas. Size is the region's, the atlas outlives it
+    void SetAtlasRegion(const Texture& atlas, int x, int y, int width, int height);
 
     // Setter
     void SetActive() const;
+    void SetDimensions(int width, int height) { mWidth = width; mHeight = height; }
 
     // Setter
     [[nodiscard]] int GetWidth() const { return mWidth; }
     [[nodiscard]] int GetHeight() const { return mHeight; }
+    [[nodiscard]] unsigned int GetTextureID() const { return mTextureID; }
+    // Texture coords of the image, whole texture unless it's an atlas region
+    [[nodiscard]] const Vector2& GetUVMin() const { return mUVMin; }
+    [[nodiscard]] const Vector2& GetUVMax() const { return mUVMax; }
+    // Decoded pixels before upload, nullptr if only dimensions were read
+    [[nodiscard]] const unsigned char* GetPixels() const { return mPixels; }
+    [[nodiscard]] int GetChannels() const { return mChannel; }
 
 private:
     // OpenGL ID of this texture
@@ -25,4 +47,10 @@ private:
     int mWidth = 0;
     int mHeight = 0;
     int mChannel = 0;
+    // Decoded pixels waiting for upload
+    unsigned char *mPixels = nullptr;
+    // Atlas regions share the atlas GL texture and don't delete it
+    bool mAtlasRegion = false;
+    Vector2 mUVMin{0.0f, 0.0f};
+    Vector2 mUVMax{1.0f, 1.0f};
 };
@@ -0,0 +1,24 @@
+#include "UniformBuffer.hpp"
+#include <cstring>
+#include <glad/glad.h>
+#include "RingBuffer.hpp"
+
+UniformBuffer::UniformBuffer(RingBuffer *ring, unsigned int bindingPoint)
+        : mRing(ring), mBindingPoint(bindingPoint) {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment > 0) {
+        mAlignment = static_cast<size_t>(alignment);
+    }
+}
+
+void UniformBuffer::Update(const void *data, size_t size) const {
+    size_t offset = 0;
+    void *dest = mRing->Map(size, mAlignment, offset);
+    memcpy(dest, data, size);
+    mRing->Unmap();
+
+    // Every shader reads the block from the binding point
+    glBindBufferRange(GL_UNIFORM_BUFFER, mBindingPoint, mRing->GetBuffer(), static_cast<GLintptr>(offset),
+                      static_cast<GLsizeiptr>(size));
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+// Uniform block data bound to a fixed binding point, shaders link their uniform block to the same point.
+// Every update is a fresh copy in the frame ring buffer, the GPU may still read the previous ones
+class UniformBuffer {
+public:
+    UniformBuffer(class RingBuffer* ring, unsigned int bindingPoint);
+
+    // Replace the whole block content, once per frame or more
+    void Update(const void* data, size_t size) const;
+
+    [[nodiscard]] unsigned int GetBindingPoint() const { return mBindingPoint; }
+
+private:
+    class RingBuffer* mRing = nullptr;
+    unsigned int mBindingPoint = 0;
+    size_t mAlignment = 256;  // offsets bound to a binding point must be multiples of this
+};
@@ -40,3 +40,15 @@ VertexArray::~VertexArray() {
 void VertexArray::SetActive() const {
     glBindVertexArray(mVertexArray);
 }
+
+void VertexArray::SetInstanceBuffer(unsigned int buffer, size_t offset) const {
+    glBindVertexArray(mVertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // A mat4 attribute takes 4 locations, each advanced once per instance
+    for (unsigned int i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(INSTANCE_ATTRIB + i);
+        glVertexAttribPointer(INSTANCE_ATTRIB + i, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 16,
+                              reinterpret_cast<void*>(offset + sizeof(float) * 4 * i));
+        glVertexAttribDivisor(INSTANCE_ATTRIB + i, 1);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 
 class VertexArray {
 public:
@@ -9,6 +10,9 @@ public:
 
     // Activate this vertex array (so we can draw it)
     void SetActive() const;
+    // Read one world transform per instance from buffer starting at offset (bytes), as 4 rows
+    // in attributes 3 to 6. Leaves this vertex array active
+    void SetInstanceBuffer(unsigned int buffer, size_t offset) const;
 
     // Getter
     [[nodiscard]] unsigned int GetNumIndices() const { return mNumIndices; }
@@ -25,6 +29,8 @@ private:
     unsigned int mIndexBuffer = 0;
     // OpenGL ID of the vertex array object
     unsigned int mVertexArray = 0;
+
+    constexpr static unsigned int INSTANCE_ATTRIB = 3;
 };
 
 
@@ -14,23 +14,22 @@ out vec4 outColor;
 // This is used for the texture sampling
 uniform sampler2D uTexture;
 
-// Create a struct for directional light
+// Specular power for this surface
+uniform float uSpecPower;
+
+// Per frame data shared by every shader, updated once per frame (Renderer::FrameUniforms)
 struct DirectionalLight {
     vec3 mDirection; // Direction of light
     vec3 mDiffuseColor; // Diffuse color
     vec3 mSpecColor; // Specular color
 };
-
-// Uniforms for lighting
-// Camera position (in world space)
-uniform vec3 uCameraPos;
-// Specular power for this surface
-uniform float uSpecPower;
-// Ambient light level
-uniform vec3 uAmbientLight;
-
-// Directional Light
-uniform DirectionalLight uDirLight;
+layout(std140, row_major) uniform FrameData {
+    mat4 uViewProj;  // world to clip space
+    mat4 uSpriteViewProj;  // screen space for sprites and UI
+    vec3 uCameraPos;  // world space
+    vec3 uAmbientLight;
+    DirectionalLight uDirLight;
+};
 
 
 void main() {
@@ -1,14 +1,27 @@
 #version 330
 // Same as sprite.vert
 
-// Uniforms for world transform and view-proj
-uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
+// Per frame data shared by every shader, updated once per frame (Renderer::FrameUniforms)
+struct DirectionalLight {
+    vec3 mDirection; // Direction of light
+    vec3 mDiffuseColor; // Diffuse color
+    vec3 mSpecColor; // Specular color
+};
+layout(std140, row_major) uniform FrameData {
+    mat4 uViewProj;  // world to clip space
+    mat4 uSpriteViewProj;  // screen space for sprites and UI
+    vec3 uCameraPos;  // world space
+    vec3 uAmbientLight;
+    DirectionalLight uDirLight;
+};
 
 // Vertex attributes
 layout(location=0) in vec3 inPosition;
 layout(location=1) in vec3 inNormal;
 layout(location=2) in vec2 inTexCoord;
+// Instance attributes, world transform of each mesh drawn in the batch.
+// Its rows arrive as columns, so multiply from the left
+layout(location=3) in mat4 inWorldTransform;
 
 // texture coord (original)
 out vec2 fragTexCoord;
@@ -21,14 +34,14 @@ void main() {
     // Convert position to homogeneous coordinates
     vec4 pos = vec4(inPosition, 1.0);
     // Transform position to world space
-    pos = pos * uWorldTransform;
+    pos = inWorldTransform * pos;
     // Save world position
     fragWorldPos = pos.xyz;
     // Transform to clip space
     gl_Position = pos * uViewProj;
 
     // Transform normal into world space (w = 0 because it's not a position, make no sense for 1)
-    fragNormal = (vec4(inNormal, 0.0f) * uWorldTransform).xyz;
+    fragNormal = (inWorldTransform * vec4(inNormal, 0.0f)).xyz;
 
     // Pass along the texture coordinate to frag shader
     fragTexCoord = inTexCoord;
@@ -1,19 +1,28 @@
 #version 330
 
-// Uniforms for world transform and view-proj
-uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
+// Per frame data shared by every shader, updated once per frame (Renderer::FrameUniforms)
+struct DirectionalLight {
+    vec3 mDirection; // Direction of light
+    vec3 mDiffuseColor; // Diffuse color
+    vec3 mSpecColor; // Specular color
+};
+layout(std140, row_major) uniform FrameData {
+    mat4 uViewProj;  // world to clip space
+    mat4 uSpriteViewProj;  // screen space for sprites and UI
+    vec3 uCameraPos;  // world space
+    vec3 uAmbientLight;
+    DirectionalLight uDirLight;
+};
 
-// Vertex attributes
+// Vertex attributes, position is already moved to screen space by SpriteBatch
 layout(location=0) in vec3 inPosition;
-layout(location=1) in vec3 inNormal;
 layout(location=2) in vec2 inTexCoord;
 
 out vec2 fragTexCoord;
 
 void main() {
     vec4 pos = vec4(inPosition, 1.0);
-    gl_Position = pos * uWorldTransform * uViewProj;  // transform into clip space
+    gl_Position = pos * uSpriteViewProj;  // transform into clip space
     fragTexCoord = inTexCoord;
 }
 
@@ -2,6 +2,7 @@
 #include "../helper/Texture.hpp"
 #include <vector>
 #include "../Game.hpp"
+#include "../core/Renderer.hpp"
 
 Font::Font(class Game *game) : mGame(game) { }
 
@@ -106,8 +107,7 @@ Texture *Font::RenderText(const std::string &textKey,
             // SDL_Log("Original (%d, %d), new (%d, %d), correction (%d, %d)", surf->w, surf->h, surCorrection->w, surCorrection->h, offset.x, offset.y);
 
             // Convert from surface to texture
-            texture = new Texture();
-            texture->CreateFromSurface(surCorrection);
+            texture = mGame->GetRenderer()->CreateTextureFromSurface(surCorrection);
 
             SDL_FreeSurface(surf);  // release resource
             SDL_FreeSurface(surCorrection);
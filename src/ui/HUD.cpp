@@ -1,7 +1,6 @@
 #include "HUD.hpp"
 #include <algorithm>
 #include "../helper/Texture.hpp"
-#include "../core/Shader.hpp"
 #include "../core/Renderer.hpp"
 #include "../core/PhysWorld.hpp"
 #include "../Game.hpp"
@@ -26,25 +25,25 @@ void HUD::Update(float deltaTime) {
     UpdateRadar(deltaTime);
 }
 
-void HUD::Draw(Shader *shader) {
+void HUD::Draw(SpriteBatch *batch) {
     // Crosshair depends on current target
     Texture *cross = mTargetEnemy ? mCrosshairEnemy : mCrosshair;
-    DrawTexture(shader, cross, Vector2::Zero, 2.0f);
+    DrawTexture(batch, cross, Vector2::Zero, 2.0f);
 
     // Radar
     const Vector2 cRadarPos(-390.0f, 275.0f);
-    DrawTexture(shader, mRadar, cRadarPos, 1.0f);
+    DrawTexture(batch, mRadar, cRadarPos, 1.0f);
 
     // Blips
     for (Vector2 &blip: mBlips) {
-        DrawTexture(shader, mBlipTex, cRadarPos + blip, 1.0f);
+        DrawTexture(batch, mBlipTex, cRadarPos + blip, 1.0f);
     }
 
     // Radar arrow
-    DrawTexture(shader, mRadarArrow, cRadarPos);
+    DrawTexture(batch, mRadarArrow, cRadarPos);
 
     //// Health bar
-    //DrawTexture(shader, mHealthBar, Vector2(-350.0f, -350.0f));
+    //DrawTexture(batch, mHealthBar, Vector2(-350.0f, -350.0f));
 }
 
 void HUD::AddTargetComponent(TargetComponent *tc) {
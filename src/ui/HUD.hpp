@@ -11,7 +11,7 @@ public:
     ~HUD() = default;
 
     void Update(float deltaTime) override;
-    void Draw(class Shader *shader) override;
+    void Draw(class SpriteBatch *batch) override;
 
     void AddTargetComponent(class TargetComponent *tc);
     void RemoveTargetComponent(class TargetComponent *tc);
@@ -2,7 +2,7 @@
 
 #include <utility>
 #include "../helper/Texture.hpp"
-#include "../core/Shader.hpp"
+#include "../helper/SpriteBatch.hpp"
 #include "../Game.hpp"
 #include "../core/Renderer.hpp"
 #include "Font.hpp"
@@ -34,24 +34,24 @@ void UIScreen::Update(float deltaTime) {
 
 }
 
-void UIScreen::Draw(Shader *shader) {
+void UIScreen::Draw(SpriteBatch *batch) {
     // Draw background (if exists)
     if (mBackground) {
-        DrawTexture(shader, mBackground, mBGPos);
+        DrawTexture(batch, mBackground, mBGPos);
     }
 
     // Draw title (if exists)
     if (mTitle) {
-        DrawTexture(shader, mTitle, mTitlePos);
+        DrawTexture(batch, mTitle, mTitlePos);
     }
 
     // Draw buttons
     for (auto b: mButtons) {
         // Draw background of button
         Texture *tex = b->GetHighlighted() ? mButtonOn : mButtonOff;
-        DrawTexture(shader, tex, b->GetPosition());
+        DrawTexture(batch, tex, b->GetPosition());
         // Draw text of button
-        DrawTexture(shader, b->GetNameTex(), b->GetPosition());
+        DrawTexture(batch, b->GetNameTex(), b->GetPosition());
     }
 
     // Override in subclasses to draw any textures
@@ -108,7 +108,7 @@ void UIScreen::AddButton(const std::string &name, std::function<void()> onClick)
     mNextButtonPos.y -= mButtonOff->GetHeight() + 20.0f;
 }
 
-void UIScreen::DrawTexture(class Shader *shader, class Texture *texture,
+void UIScreen::DrawTexture(class SpriteBatch *batch, class Texture *texture,
                            const Vector2 &offset, float scale) {
     // Scale the quad by the width/height of texture
     Matrix4 scaleMat = Matrix4::CreateScale(
@@ -118,13 +118,8 @@ void UIScreen::DrawTexture(class Shader *shader, class Texture *texture,
     // Translate to position on screen
     Matrix4 transMat = Matrix4::CreateTranslation(
             Vector3(offset.x, offset.y, 0.0f));
-    // Set world transform
-    Matrix4 world = scaleMat * transMat;
-    shader->SetMatrixUniform("uWorldTransform", world);
-    // Set current texture
-    texture->SetActive();
-    // Draw quad
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // Quads keep call order, later ones draw on top
+    batch->Draw(texture, scaleMat * transMat);
 }
 
 void UIScreen::SetRelativeMouseMode(bool relative) {
@@ -46,7 +46,7 @@ public:
 
     // UIScreen subclasses can override these
     virtual void Update(float deltaTime);
-    virtual void Draw(class Shader *shader);
+    virtual void Draw(class SpriteBatch *batch);
     virtual void ProcessInput(const InputState& key);  // handle input during pause
     virtual void HandleKeyPress(const InputState& key);  // handle anytime
 
@@ -71,7 +71,7 @@ public:
 
 protected:
     // Helper to draw a texture since it's not an actor
-    void DrawTexture(class Shader *shader, class Texture *texture,
+    void DrawTexture(class SpriteBatch *batch, class Texture *texture,
                      const Vector2 &offset = Vector2::Zero,
                      float scale = 1.0f);
 